@@ -1,10 +1,27 @@
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
 #include <exception>
+#include <functional>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
 #include <stdexcept>
+#include <thread>
 #include <vector>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 using namespace std;
 
 string ltrim(const string &);
@@ -13,7 +30,67 @@ vector<string> split(const string &);
 
 #define DEBUG(x) cout << "Line: " << __LINE__ << ": " << x
 
-// Square NxN board, win with N consecutive.
+// Error signalling that survives -fno-exceptions builds (embedded/kiosk
+// targets): throws where exceptions are available, aborts otherwise.  The
+// move hot path (MakeMove / ConvertMoveResultToGameResult) uses assert
+// instead, so its impossible-state checks compile out entirely in release
+// builds and both functions are noexcept.
+#if defined(__cpp_exceptions)
+#define TTT_THROW(exception) throw exception
+#else
+#define TTT_THROW(exception) abort()
+#endif
+
+// Square NxN board, win with K consecutive (K == N, the full-line classic,
+// by default).
+
+/// \brief Contiguous bit-packed cell storage for player values.
+///
+/// One allocation of 64-bit words with a runtime cell width, so a board's
+/// cells use only as many bits as the player count needs: a 2-bit-cell 3x3
+/// board is 18 bits and whole boards fit in single cache lines.  Cell order
+/// is the caller's (row-major for boards).
+class PackedCellArray {
+ public:
+  /// \brief Size the array for \p num_cells cells of \p bits bits each,
+  /// zeroing every cell.  bits must divide 64.
+  void Initialize(int num_cells, int bits) {
+    bits_per_cell = bits;
+    cells_per_word = 64 / bits;
+    words.assign((num_cells + cells_per_word - 1) / cells_per_word, 0);
+  }
+
+  /// \brief Read cell \p index.
+  int Get(int index) const {
+    const uint64_t word = words[index / cells_per_word];
+    const int shift = (index % cells_per_word) * bits_per_cell;
+    return static_cast<int>((word >> shift) & ValueMask());
+  }
+
+  /// \brief Write \p value to cell \p index.
+  void Set(int index, int value) {
+    uint64_t &word = words[index / cells_per_word];
+    const int shift = (index % cells_per_word) * bits_per_cell;
+    word = (word & ~(ValueMask() << shift)) |
+           (static_cast<uint64_t>(value) << shift);
+  }
+
+  /// \brief Zero every cell, keeping the allocation.
+  void Clear() { fill(words.begin(), words.end(), 0); }
+
+ private:
+  /// \brief Mask of one cell's value bits.
+  uint64_t ValueMask() const { return (uint64_t{1} << bits_per_cell) - 1; }
+
+  /// \brief The packed cells.
+  vector<uint64_t> words;
+
+  /// \brief Bits per cell; divides 64.
+  int bits_per_cell = 32;
+
+  /// \brief Cells stored per word.
+  int cells_per_word = 2;
+};
 
 /// \brief Class to play Tic Tac Toe.
 class TicTacToe {
@@ -23,11 +100,18 @@ class TicTacToe {
   /// \brief Defines the result of a single move.
   enum class MoveResult { WIN, INVALID, DRAW, CONTINUE, NUM_MOVE_RESULT };
 
+  /// \brief Fine-grained classification of a candidate move, for query paths
+  /// that must not commit anything (see ClassifyMove).
+  enum class MoveClass { VALID, WRONG_TURN, OFF_BOARD, OCCUPIED,
+                         NUM_MOVE_CLASS };
+
   /// \brief Defines a location on the board.
   struct Location {
     Location(int row, int col) : row(row), col(col) {}
-    const int row;
-    const int col;
+    // Non-const so locations (and anything holding one) stay assignable and
+    // movable.
+    int row;
+    int col;
   };
 
   /// \brief Constructor.
@@ -35,28 +119,238 @@ class TicTacToe {
   /// \param numPlayers The number of players who will participate.
   TicTacToe(int boardSize, int numberPlayers);
 
+  /// \brief Constructor for Gomoku-style K-in-a-row variants.
+  /// \param boardSize Board size for this game.  boardSize N -> NxN board.
+  /// \param numPlayers The number of players who will participate.
+  /// \param winLength Number of consecutive cells needed to win; must be in
+  /// [1, boardSize].  winLength == boardSize is the classic full-line game.
+  TicTacToe(int boardSize, int numberPlayers, int winLength);
+
   /// \brief MakeMove Interface for the game playing system to add a new move to
   /// the game.
   /// \param player   Player making this move.
   /// \param location The selected location on the board.
   /// \return Result of the move, including the new game status such as Win,
   /// Invalid, etc.
-  MoveResult MakeMove(Player player, Location location);
+  ///
+  /// noexcept: impossible internal states assert in debug builds and compile
+  /// out in release, so the validate/write/check sequence inlines fully and
+  /// the engine builds with -fno-exceptions.  (Growing the optional move
+  /// history under memory exhaustion terminates, as any noexcept path does.)
+  MoveResult MakeMove(Player player, Location location) noexcept;
 
   /// \brief Convert a move result into an actual game result.
   /// \param result The move result.
   /// \param player The player making the move.
-  int ConvertMoveResultToGameResult(MoveResult result, Player player);
+  ///
+  /// noexcept: passing the NUM_MOVE_RESULT sentinel asserts in debug builds
+  /// and is reported as an invalid move in release.
+  int ConvertMoveResultToGameResult(MoveResult result, Player player) noexcept;
 
   /// \brief Print the current game board.
   void Print();
 
+  /// \brief Render the board into \p output in Print's human-readable format.
+  /// \param output Caller-supplied buffer; cleared, then filled.
+  ///
+  /// Formats the whole board into one buffer so callers (e.g. an async
+  /// logging layer) can emit it with a single write instead of one stream
+  /// operation per cell.  The buffer's capacity is reused across calls.
+  void Render(string &output) const;
+
+  /// \brief Render a compact single-line serialization for machine
+  /// consumption: "<board_size>:<cells>" with row-major cells, one digit per
+  /// cell when every player fits a digit, comma-separated otherwise.
+  /// \param output Caller-supplied buffer; cleared, then filled.
+  void RenderCompact(string &output) const;
+
+  /// \brief Reinitialize the game for a fresh play-through in place.
+  ///
+  /// Clears the board, the win-line counters, the move count, the turn, and
+  /// the undo/redo history without releasing or reacquiring any storage, so a
+  /// pooled instance can be reused for a new game with zero allocations (see
+  /// GamePool).
+  void Reset();
+
+  /// \brief Cheap snapshot for speculative simulation: copy this game's
+  /// state into \p target, reusing target's existing storage.
+  /// \param target A game with the same (boardSize, numberPlayers,
+  /// winLength) configuration — e.g. from the same GamePool.
+  /// \return false (target untouched) on a configuration mismatch.
+  ///
+  /// With the packed board this is a handful of word copies into already
+  /// allocated vectors, so once a simulation worker's target is warmed up,
+  /// cloning allocates nothing.  Undo/redo history does not follow the
+  /// clone; the Zobrist key table is shared work (fixed seed) and only built
+  /// in the target when the source hashes.  TicTacToe is also plainly
+  /// copyable and movable for one-off clones.
+  bool CloneInto(TicTacToe &target) const;
+
+  /// \brief Number of bytes a snapshot of this game occupies.
+  ///
+  /// Fixed for a given configuration: six header bytes (configuration and
+  /// scalars) plus the packed cells — one nibble per cell for up to 15
+  /// players, one byte otherwise.  Valid for boards up to 255x255.
+  size_t SerializedSize() const;
+
+  /// \brief Snapshot the game state into \p buffer.
+  /// \param buffer Caller-provided storage of at least SerializedSize()
+  /// bytes.
+  /// \return The number of bytes written.
+  ///
+  /// The layout is a compact fixed encoding of the board and scalar fields;
+  /// no parsing is involved on either side, so checkpointing a fleet of
+  /// games is bounded by memory bandwidth, not move-replay speed.
+  size_t Serialize(uint8_t *buffer) const;
+
+  /// \brief Rebuild this game from a snapshot in O(board bytes).
+  /// \param buffer Snapshot previously written by Serialize.
+  /// \param size Number of bytes available at \p buffer.
+  /// \return true on success; false if the snapshot is truncated, was taken
+  /// from a different configuration, or contains out-of-range values.
+  ///
+  /// Derived state (win-line counters, position hash) is recomputed; the
+  /// undo/redo history does not survive a checkpoint.
+  bool Restore(const uint8_t *buffer, size_t size);
+
+  /// \brief Enable or disable move-history recording for UndoMove/RedoMove.
+  ///
+  /// Off by default so the replay hot paths stay allocation-free; analysis
+  /// tooling that explores move trees turns it on once per game.
+  void SetMoveHistoryEnabled(bool enabled) { history_enabled = enabled; }
+
+  /// \brief Classify a candidate move against the current position without
+  /// committing it.
+  /// \param player Player proposing the move.
+  /// \param location The proposed location.
+  /// \return The first applicable class, checked in the order wrong turn,
+  /// off board, occupied.
+  ///
+  /// Pure query: unlike MakeMove, this never mutates anything — in
+  /// particular it does not advance whose_turn, so read paths (anti-cheat,
+  /// hint generation) can probe candidates freely.
+  MoveClass ClassifyMove(Player player, Location location) const {
+    if (player != whose_turn) {
+      return MoveClass::WRONG_TURN;
+    }
+    if (location.row < 0 || location.row >= board_size || location.col < 0 ||
+        location.col >= board_size) {
+      return MoveClass::OFF_BOARD;
+    }
+    if (Cell(location.row, location.col) != NO_MOVE) {
+      return MoveClass::OCCUPIED;
+    }
+    return MoveClass::VALID;
+  }
+
+  /// \brief The player expected to move next (1-indexed).
+  int WhoseTurn() const { return whose_turn; }
+
+  /// \brief The player occupying (row, col), or 0 for an empty cell.
+  Player CellAt(int row, int col) const { return Cell(row, col); }
+
+  /// \brief Board size accessor.  boardSize N -> NxN board.
+  int BoardSize() const { return board_size; }
+
+  /// \brief Number of players accessor.
+  int NumPlayers() const { return num_players; }
+
+  /// \brief Scan the whole position for an existing win, independent of move
+  /// order.
+  /// \return The first player found holding win_length-in-a-row, or 0 (no
+  /// win).
+  ///
+  /// Bulk-analysis entry point: evaluates every row, column, and diagonal in
+  /// one pass over the contiguous packed board, without replaying moves.
+  /// For boards up to 32 wide it builds per-row occupancy bitmasks (with
+  /// 2-bit cells an entire row's cells arrive in a single word read) and
+  /// detects runs with shift-AND windows; larger boards fall back to a
+  /// scalar run scan.
+  Player ScanBoard() const;
+
+  /// \brief Enable Zobrist position hashing, maintained incrementally by
+  /// MakeMove/UndoMove and exposed via Hash().
+  ///
+  /// Builds the per-(cell, player) key table on first enable (the only
+  /// allocation) and recomputes the absolute hash of the current position,
+  /// so enabling mid-game is safe; afterwards each move costs one XOR.  Off
+  /// by default so construction and replay hot paths are unaffected.
+  void SetHashingEnabled(bool enabled);
+
+  /// \brief The Zobrist hash of the current position (0 for the empty
+  /// board).  Positions reached by different move orders hash equal.
+  uint64_t Hash() const { return zobrist_hash; }
+
+  /// \brief The Zobrist hash of the position's canonical orientation.
+  ///
+  /// The board has an 8-element symmetry group (4 rotations x mirror); all
+  /// eight orientations of a position return the same value, computed as the
+  /// hash of the lexicographically-minimal transform, so dedup and
+  /// transposition tables keyed on it shrink up to 8x.  Builds the Zobrist
+  /// key table on first use if hashing hasn't been enabled.
+  uint64_t CanonicalHash();
+
+  /// \brief Dense index of the position's canonical orientation: the cells
+  /// of the lexicographically-minimal transform read as base-(num_players+1)
+  /// digits.
+  ///
+  /// Unlike CanonicalHash this is collision-free and contiguous — every
+  /// possible board maps to a distinct index below (num_players+1)^(N*N) —
+  /// which is what a dense tablebase wants.  Only meaningful where that
+  /// power fits 64 bits (small boards; see Tablebase).
+  uint64_t CanonicalIndex() const;
+
+  /// \brief Roll back the most recent MakeMove in O(1).
+  /// \return true if a move was undone; false if there is no history (or
+  /// recording is disabled).
+  ///
+  /// Every MakeMove call is undoable, including INVALID ones — they advance
+  /// whose_turn, so skipping them would desynchronize the rollback.
+  bool UndoMove();
+
+  /// \brief Reapply the most recently undone move in O(1).
+  /// \return true if a move was redone; false if there is nothing to redo.
+  ///
+  /// Any new MakeMove invalidates the redo history, as in any editor.
+  bool RedoMove();
+
   // Game status definitions.
   static constexpr int NEXT_PLAYER = 0;
-  const int CATS_GAME;
+  int CATS_GAME;
 
  private:
-  typedef vector<vector<Player>> board_t;
+  // Row-major contiguous storage: cell (row, col) lives at packed index
+  // row * board_size + col. A single allocation of width-sized cells (2 bits
+  // for up to 3 players, 4 for up to 15, then 8/32) keeps whole boards in
+  // single cache lines and cuts the memory the win scans touch.
+  typedef PackedCellArray board_t;
+
+  /// \brief The cell width in bits needed for \p numberPlayers players.
+  static int BitsPerCell(int numberPlayers) {
+    if (numberPlayers <= 3) {
+      return 2;
+    }
+    if (numberPlayers <= 15) {
+      return 4;
+    }
+    return numberPlayers <= 255 ? 8 : 32;
+  }
+
+  /// \brief Compute the flat index of a board location.
+  /// \param row Row of the cell.
+  /// \param col Column of the cell.
+  /// \return Index into <board> for cell (row, col).
+  int CellIndex(int row, int col) const { return row * board_size + col; }
+
+  /// \brief Read the cell at (row, col).
+  Player Cell(int row, int col) const {
+    return board.Get(CellIndex(row, col));
+  }
+
+  /// \brief Write \p player to the cell at (row, col).
+  void SetCell(int row, int col, Player player) {
+    board.Set(CellIndex(row, col), player);
+  }
 
   /// \brief Check if \p player just won playing at \location.
   /// \param location \p player's most recent move.
@@ -65,39 +359,456 @@ class TicTacToe {
   ///
   /// This function only returns WIN or CONTINUE. It assumes that only those two
   /// possibilities are left / all error-check has already been performed.
+  ///
+  /// This rescans the full row, column, and diagonals in O(board_size); the
+  /// hot path uses UpdateLineCountsAndCheckForWin instead, and this scan is
+  /// kept as a debug cross-check (see TTT_DEBUG_CROSS_CHECK_WIN).
   MoveResult CheckForWin(Location location, Player player);
 
+  /// \brief Record \p player's move at \p location in the per-line win
+  /// counters and check whether it completed a line.
+  /// \param location \p player's most recent move.
+  /// \param player The player of this turn only.
+  /// \return MoveResult::WIN or MoveResult::CONTINUE.
+  ///
+  /// Same contract as CheckForWin, but O(1): each player owns a counter per
+  /// row, column, and diagonal, incremented as moves land, so a win is just a
+  /// comparison of the touched counters against board_size.
+  MoveResult UpdateLineCountsAndCheckForWin(Location location, Player player);
+
+  /// \brief Check if \p player just won at \p location with a windowed
+  /// K-in-a-row scan.
+  /// \param location \p player's most recent move.
+  /// \param player The player of this turn only.
+  /// \return MoveResult::WIN or MoveResult::CONTINUE.
+  ///
+  /// Used when win_length < board_size: scans at most win_length - 1 cells
+  /// outward from the move in each of the four line directions, so the cost
+  /// stays O(win_length) no matter how large the board grows.
+  MoveResult CheckForWinWindowed(Location location, Player player) const;
+
+  /// \brief Compute the index into <line_counts> for \p player's counter on
+  /// line \p line (see <line_counts> for the line numbering).
+  int LineCountIndex(Player player, int line) const {
+    // Players are 1-indexed; each player owns a block of num_lines counters.
+    return (player - 1) * num_lines + line;
+  }
+
+  /// \brief One undoable MakeMove call.
+  struct MoveHistoryEntry {
+    /// \brief Where the move was aimed.
+    Location location;
+
+    /// \brief Who submitted it.
+    Player player;
+
+    /// \brief whose_turn before the move.
+    int prior_whose_turn;
+
+    /// \brief valid_move_count before the move.
+    unsigned int prior_valid_move_count;
+
+    /// \brief Whether the move landed on the board.  INVALID moves and
+    /// full-board DRAWs leave the board untouched; early-draw moves write it.
+    bool wrote_cell;
+  };
+
   /// \brief Structure to store current game state.
   board_t board;
 
+  /// \brief Per-player win-line counters, one block of <num_lines> counters
+  /// per player: lines [0, board_size) are rows, [board_size, 2*board_size)
+  /// are columns, then the down diagonal and the up diagonal.
+  vector<unsigned int> line_counts;
+
+  /// \brief Marks a line no player can complete anymore (two different
+  /// players have stones on it).
+  static constexpr int8_t LINE_DEAD = -1;
+
+  /// \brief Per-line winnability, same numbering as <line_counts>: 0 for an
+  /// untouched line, the sole player with stones on it, or LINE_DEAD.  One
+  /// byte per line keeps the whole index cache-resident.  Only maintained
+  /// for full-line (win_length == board_size) games.
+  vector<int8_t> line_owners;
+
+  /// \brief Number of lines not yet LINE_DEAD; 0 means no one can ever win,
+  /// and MakeMove reports DRAW immediately.
+  int winnable_lines = 0;
+
+  /// \brief Update \p line's winnability for a stone just placed by
+  /// \p player.
+  void MarkLine(int line, Player player) {
+    const int8_t owner = line_owners[line];
+    if (owner == 0) {
+      line_owners[line] = static_cast<int8_t>(player);
+    } else if (owner != LINE_DEAD && owner != player) {
+      line_owners[line] = LINE_DEAD;
+      --winnable_lines;
+    }
+  }
+
+  /// \brief Recompute \p line's winnability from the line counters (used
+  /// when rolling back or restoring), adjusting <winnable_lines>.
+  void RefreshLineOwner(int line) {
+    int8_t owner = 0;
+    for (Player player = 1; player <= num_players; ++player) {
+      if (line_counts[LineCountIndex(player, line)] > 0) {
+        if (owner != 0) {
+          owner = LINE_DEAD;
+          break;
+        }
+        owner = static_cast<int8_t>(player);
+      }
+    }
+    if (line_owners[line] == LINE_DEAD && owner != LINE_DEAD) {
+      ++winnable_lines;
+    } else if (line_owners[line] != LINE_DEAD && owner == LINE_DEAD) {
+      --winnable_lines;
+    }
+    line_owners[line] = owner;
+  }
+
   /// \brief Counter for the number of valid moves made in the game.
   unsigned int valid_move_count = 0;
 
   /// \brief Board size.
-  const int board_size;
+  int board_size;
 
   /// \brief The number of players.
-  const int num_players;
+  int num_players;
 
   /// \brief The maximum number of total moves by all players combined.
-  const int max_valid_moves;
+  int max_valid_moves;
+
+  /// \brief The number of win lines on the board: board_size rows, board_size
+  /// columns, and the two diagonals.
+  int num_lines;
+
+  /// \brief Number of consecutive cells needed to win.  Equal to board_size
+  /// for the classic full-line game.
+  int win_length;
 
   // Board data definitions.
-  const Player NO_MOVE = 0;
+  static constexpr Player NO_MOVE = 0;
 
   // Keep track of whose turn it is.
   int whose_turn;
+
+  /// \brief Build the per-(cell, player) Zobrist key table if it doesn't
+  /// exist yet (the only allocation hashing ever performs).
+  void EnsureZobristTable();
+
+  /// \brief The lexicographically-minimal orientation of the current board
+  /// (see TransformedIndex for the numbering).
+  int FindCanonicalTransform() const;
+
+  /// \brief The board index that orientation \p transform reads from for
+  /// output cell (row, col).  Transforms 0-3 are rotations, 4-7 their
+  /// mirrors.
+  int TransformedIndex(int transform, int row, int col) const {
+    const int m = board_size - 1;
+    switch (transform) {
+      case 0:
+        return CellIndex(row, col);
+      case 1:
+        return CellIndex(col, m - row);
+      case 2:
+        return CellIndex(m - row, m - col);
+      case 3:
+        return CellIndex(m - col, row);
+      case 4:
+        return CellIndex(row, m - col);
+      case 5:
+        return CellIndex(col, row);
+      case 6:
+        return CellIndex(m - row, col);
+      default:
+        return CellIndex(m - col, m - row);
+    }
+  }
+
+  /// \brief The Zobrist key for \p player occupying \p location.
+  uint64_t ZobristKey(Location location, Player player) const {
+    return zobrist_table[CellIndex(location.row, location.col) * num_players +
+                         (player - 1)];
+  }
+
+  /// \brief Whether MakeMove records history for UndoMove/RedoMove.
+  bool history_enabled = false;
+
+  /// \brief Whether MakeMove/UndoMove maintain the Zobrist hash.
+  bool hashing_enabled = false;
+
+  /// \brief Per-(cell, player) random keys; built on first
+  /// SetHashingEnabled(true).
+  vector<uint64_t> zobrist_table;
+
+  /// \brief Incrementally maintained hash of the current position.
+  uint64_t zobrist_hash = 0;
+
+  /// \brief Set while RedoMove replays a move, so MakeMove doesn't clear the
+  /// redo stack it is being driven from.
+  bool replaying_redo = false;
+
+  /// \brief Undo stack: every recorded MakeMove, most recent last.
+  vector<MoveHistoryEntry> history;
+
+  /// \brief Redo stack: undone moves available for RedoMove.
+  vector<MoveHistoryEntry> redo_stack;
+};
+
+#if defined(TTT_INSTRUMENT) || defined(TTT_TELEMETRY)
+/// \brief A raw timestamp: TSC cycles on x86-64, nanoseconds elsewhere.
+/// Shared by the TTT_INSTRUMENT and TTT_TELEMETRY surfaces.
+inline uint64_t InstrumentationCycles() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __builtin_ia32_rdtsc();
+#else
+  return static_cast<uint64_t>(
+      chrono::duration_cast<chrono::nanoseconds>(
+          chrono::steady_clock::now().time_since_epoch())
+          .count());
+#endif
+}
+#endif
+
+// Hot-path instrumentation, compile-time gated behind TTT_INSTRUMENT: per
+// MakeMove stage cycle counters (validation / board write / win check) and a
+// move-result histogram, accumulated per thread with zero synchronization
+// and zero overhead when the flag is off.
+#ifdef TTT_INSTRUMENT
+
+/// \brief Per-thread MakeMove counters; dump on demand with Dump().
+struct MoveInstrumentation {
+  /// \brief Cycles spent in the wrong-player/off-board/occupied checks.
+  uint64_t validation_cycles = 0;
+
+  /// \brief Cycles spent writing the board (and hash) for valid moves.
+  uint64_t write_cycles = 0;
+
+  /// \brief Cycles spent in the win check for valid moves.
+  uint64_t win_check_cycles = 0;
+
+  /// \brief Total MakeMove calls recorded.
+  uint64_t move_count = 0;
+
+  /// \brief How often each MoveResult was returned; NUM_MOVE_RESULT bounds
+  /// the histogram.
+  uint64_t result_histogram[static_cast<int>(
+      TicTacToe::MoveResult::NUM_MOVE_RESULT)] = {};
+
+  /// \brief Record one MakeMove's stage timestamps.
+  void Record(TicTacToe::MoveResult result, uint64_t start, uint64_t validated,
+              uint64_t written, uint64_t checked) {
+    validation_cycles += validated - start;
+    write_cycles += written - validated;
+    win_check_cycles += checked - written;
+    ++move_count;
+    ++result_histogram[static_cast<int>(result)];
+  }
+
+  /// \brief Write this thread's counters to \p output.
+  void Dump(ostream &output) const {
+    output << "moves=" << move_count
+           << " validation_cycles=" << validation_cycles
+           << " write_cycles=" << write_cycles
+           << " win_check_cycles=" << win_check_cycles << " results[win]="
+           << result_histogram[static_cast<int>(TicTacToe::MoveResult::WIN)]
+           << " results[invalid]="
+           << result_histogram[static_cast<int>(
+                  TicTacToe::MoveResult::INVALID)]
+           << " results[draw]="
+           << result_histogram[static_cast<int>(TicTacToe::MoveResult::DRAW)]
+           << " results[continue]="
+           << result_histogram[static_cast<int>(
+                  TicTacToe::MoveResult::CONTINUE)]
+           << "\n";
+  }
+};
+
+/// \brief The calling thread's MakeMove counters.
+thread_local MoveInstrumentation tls_move_instrumentation;
+
+#endif  // TTT_INSTRUMENT
+
+// Operational telemetry, compile-time gated behind TTT_TELEMETRY: per-thread
+// move/game counters and a log2-bucketed (HDR-style) MakeMove latency
+// histogram, accumulated with relaxed atomics (plain stores on x86, no
+// cross-thread contention) and merged only at export time.  Zero overhead
+// when the flag is off.
+#ifdef TTT_TELEMETRY
+
+/// \brief Process-wide telemetry registry with per-thread accumulation and a
+/// Prometheus text exporter.
+class MoveTelemetry {
+ public:
+  /// \brief Number of log2 latency buckets: bucket b holds samples with
+  /// cycles in [2^(b-1), 2^b).
+  static constexpr int NUM_BUCKETS = 64;
+
+  /// \brief Record one MakeMove: its cycle cost and whether it completed the
+  /// game (win or draw).  Touches only the calling thread's counters.
+  static void Record(uint64_t cycles, bool game_completed) {
+    ThreadCounters &counters = Local();
+    counters.moves.fetch_add(1, memory_order_relaxed);
+    if (game_completed) {
+      counters.games_completed.fetch_add(1, memory_order_relaxed);
+    }
+    const int bucket =
+        cycles == 0 ? 0 : 64 - __builtin_clzll(cycles);
+    counters.latency_buckets[bucket < NUM_BUCKETS ? bucket : NUM_BUCKETS - 1]
+        .fetch_add(1, memory_order_relaxed);
+    counters.latency_sum.fetch_add(cycles, memory_order_relaxed);
+  }
+
+  /// \brief Merge every thread's counters and write them in Prometheus text
+  /// format.
+  static void ExportPrometheus(ostream &output) {
+    uint64_t moves = 0;
+    uint64_t games = 0;
+    uint64_t sum = 0;
+    uint64_t buckets[NUM_BUCKETS] = {};
+    {
+      lock_guard<mutex> lock(RegistryMutex());
+      for (const auto &counters : Registry()) {
+        moves += counters->moves.load(memory_order_relaxed);
+        games += counters->games_completed.load(memory_order_relaxed);
+        sum += counters->latency_sum.load(memory_order_relaxed);
+        for (int b = 0; b < NUM_BUCKETS; ++b) {
+          buckets[b] += counters->latency_buckets[b].load(memory_order_relaxed);
+        }
+      }
+    }
+    output << "# TYPE tictactoe_moves_total counter\n"
+           << "tictactoe_moves_total " << moves << "\n"
+           << "# TYPE tictactoe_games_completed_total counter\n"
+           << "tictactoe_games_completed_total " << games << "\n"
+           << "# TYPE tictactoe_move_latency_cycles histogram\n";
+    uint64_t cumulative = 0;
+    for (int b = 0; b < NUM_BUCKETS; ++b) {
+      if (buckets[b] == 0) {
+        continue;
+      }
+      cumulative += buckets[b];
+      output << "tictactoe_move_latency_cycles_bucket{le=\""
+             << (uint64_t{1} << b) << "\"} " << cumulative << "\n";
+    }
+    output << "tictactoe_move_latency_cycles_bucket{le=\"+Inf\"} " << moves
+           << "\n"
+           << "tictactoe_move_latency_cycles_sum " << sum << "\n"
+           << "tictactoe_move_latency_cycles_count " << moves << "\n";
+  }
+
+  /// \brief Start a background thread that rewrites \p path (atomically, via
+  /// rename) every \p interval_seconds — the Prometheus textfile-collector
+  /// pattern.  Stopped by StopExporter, or automatically at process exit (a
+  /// joinable static thread at exit would otherwise terminate the process).
+  static void StartExporter(const string &path, int interval_seconds) {
+    StopExporter();
+    // Construct every function-local static the exporter thread and the
+    // atexit handler touch BEFORE registering the handler: if their first
+    // use happened on the exporter thread, they would be destroyed before
+    // the handler joins it, and the final export would walk destroyed state.
+    Registry();
+    RegistryMutex();
+    ExporterRunning();
+    ExporterThread();
+    static const int registered = atexit([] { StopExporter(); });
+    (void)registered;
+    ExporterRunning().store(true);
+    ExporterThread() = thread([path, interval_seconds]() {
+      const string temp_path = path + ".tmp";
+      while (ExporterRunning().load()) {
+        {
+          ofstream file(temp_path);
+          ExportPrometheus(file);
+        }
+        rename(temp_path.c_str(), path.c_str());
+        for (int tick = 0; tick < interval_seconds * 10 &&
+                           ExporterRunning().load();
+             ++tick) {
+          this_thread::sleep_for(chrono::milliseconds(100));
+        }
+      }
+    });
+  }
+
+  /// \brief Stop and join the background exporter, if running.
+  static void StopExporter() {
+    ExporterRunning().store(false);
+    if (ExporterThread().joinable()) {
+      ExporterThread().join();
+    }
+  }
+
+ private:
+  /// \brief One thread's counters; relaxed atomics so the exporter can read
+  /// them without stopping the world.
+  struct ThreadCounters {
+    atomic<uint64_t> moves{0};
+    atomic<uint64_t> games_completed{0};
+    atomic<uint64_t> latency_sum{0};
+    atomic<uint64_t> latency_buckets[NUM_BUCKETS] = {};
+  };
+
+  /// \brief The calling thread's counters, registered on first use.
+  /// Counters outlive their thread so totals never go backwards.
+  static ThreadCounters &Local() {
+    thread_local ThreadCounters *counters = nullptr;
+    if (counters == nullptr) {
+      auto owned = make_unique<ThreadCounters>();
+      counters = owned.get();
+      lock_guard<mutex> lock(RegistryMutex());
+      Registry().push_back(std::move(owned));
+    }
+    return *counters;
+  }
+
+  static vector<unique_ptr<ThreadCounters>> &Registry() {
+    static vector<unique_ptr<ThreadCounters>> registry;
+    return registry;
+  }
+
+  static mutex &RegistryMutex() {
+    static mutex registry_mutex;
+    return registry_mutex;
+  }
+
+  static atomic<bool> &ExporterRunning() {
+    static atomic<bool> running{false};
+    return running;
+  }
+
+  static thread &ExporterThread() {
+    static thread exporter;
+    return exporter;
+  }
 };
 
+#endif  // TTT_TELEMETRY
+
 TicTacToe::TicTacToe(int boardSize, int numberPlayers)
+    : TicTacToe(boardSize, numberPlayers, boardSize) {}
+
+TicTacToe::TicTacToe(int boardSize, int numberPlayers, int winLength)
     : CATS_GAME(numberPlayers + 1),
       board_size(boardSize),
       num_players(numberPlayers),
-      max_valid_moves(boardSize * boardSize) {
-  // Initialize board to reflect that no players have played yet.
-  const vector<int> initial_row(board_size, NO_MOVE);
-  for (int i = 0; i < board_size; ++i) {
-    board.push_back(initial_row);
+      max_valid_moves(boardSize * boardSize),
+      num_lines(2 * boardSize + 2),
+      win_length(winLength) {
+  // Initialize board to reflect that no players have played yet.  One
+  // contiguous allocation covers all board_size * board_size cells at the
+  // narrowest width the player count allows.
+  board.Initialize(max_valid_moves, BitsPerCell(num_players));
+
+  // No lines have any moves on them yet.
+  line_counts.assign(num_players * num_lines, 0);
+
+  // Full-line games track per-line winnability for early-draw detection.
+  if (win_length == board_size) {
+    line_owners.assign(num_lines, 0);
+    winnable_lines = num_lines;
   }
 
   // Set who must go first.  Player 1 goes first.  Note that players are
@@ -105,12 +816,201 @@ TicTacToe::TicTacToe(int boardSize, int numberPlayers)
   whose_turn = 1;
 }
 
+void TicTacToe::Reset() {
+  // Clear()/fill() reuse the existing heap blocks: no allocation.
+  board.Clear();
+  fill(line_counts.begin(), line_counts.end(), 0u);
+  fill(line_owners.begin(), line_owners.end(), int8_t{0});
+  winnable_lines = static_cast<int>(line_owners.size());
+  valid_move_count = 0;
+  // Player 1 goes first, as in the constructor.
+  whose_turn = 1;
+  history.clear();
+  redo_stack.clear();
+  // The empty board hashes to 0; the key table is config-bound and kept.
+  zobrist_hash = 0;
+}
+
+bool TicTacToe::CloneInto(TicTacToe &target) const {
+  if (target.board_size != board_size || target.num_players != num_players ||
+      target.win_length != win_length) {
+    return false;
+  }
+  // Vector assignments below reuse the target's heap blocks: no allocation
+  // once the target has been cloned into (or played) once.
+  target.board = board;
+  target.line_counts = line_counts;
+  target.line_owners = line_owners;
+  target.winnable_lines = winnable_lines;
+  target.valid_move_count = valid_move_count;
+  target.whose_turn = whose_turn;
+  target.hashing_enabled = hashing_enabled;
+  target.zobrist_hash = zobrist_hash;
+  if (hashing_enabled) {
+    // The key table is deterministic per configuration; build rather than
+    // copy so repeated clones never touch its 8 bytes per (cell, player).
+    target.EnsureZobristTable();
+  }
+  target.history_enabled = history_enabled;
+  target.history.clear();
+  target.redo_stack.clear();
+  target.replaying_redo = false;
+  return true;
+}
+
+size_t TicTacToe::SerializedSize() const {
+  const size_t cell_bytes = (num_players <= 15)
+                                ? (max_valid_moves + 1) / 2
+                                : static_cast<size_t>(max_valid_moves);
+  return 6 + cell_bytes;
+}
+
+size_t TicTacToe::Serialize(uint8_t *buffer) const {
+  buffer[0] = static_cast<uint8_t>(board_size);
+  buffer[1] = static_cast<uint8_t>(num_players);
+  buffer[2] = static_cast<uint8_t>(win_length);
+  buffer[3] = static_cast<uint8_t>(whose_turn);
+  buffer[4] = static_cast<uint8_t>(valid_move_count & 0xFF);
+  buffer[5] = static_cast<uint8_t>((valid_move_count >> 8) & 0xFF);
+  uint8_t *cells = buffer + 6;
+  if (num_players <= 15) {
+    // One nibble per cell, low nibble first.
+    for (int idx = 0; idx < max_valid_moves; idx += 2) {
+      const uint8_t low = static_cast<uint8_t>(board.Get(idx));
+      const uint8_t high =
+          (idx + 1 < max_valid_moves)
+              ? static_cast<uint8_t>(board.Get(idx + 1))
+              : 0;
+      cells[idx / 2] = static_cast<uint8_t>(low | (high << 4));
+    }
+  } else {
+    for (int idx = 0; idx < max_valid_moves; ++idx) {
+      cells[idx] = static_cast<uint8_t>(board.Get(idx));
+    }
+  }
+  return SerializedSize();
+}
+
+bool TicTacToe::Restore(const uint8_t *buffer, size_t size) {
+  if (size < SerializedSize()) {
+    return false;
+  }
+  if (buffer[0] != board_size || buffer[1] != num_players ||
+      buffer[2] != win_length) {
+    return false;
+  }
+  const int restored_turn = buffer[3];
+  if (restored_turn < 1 || restored_turn > num_players) {
+    return false;
+  }
+  const unsigned int restored_count =
+      buffer[4] | (static_cast<unsigned int>(buffer[5]) << 8);
+  if (restored_count > static_cast<unsigned int>(max_valid_moves)) {
+    return false;
+  }
+  // Validate every cell before touching the game, so a rejected snapshot
+  // leaves this instance exactly as it was.
+  const uint8_t *cells = buffer + 6;
+  const auto unpack_cell = [this, cells](int idx) {
+    return (num_players <= 15)
+               ? static_cast<Player>((cells[idx / 2] >> ((idx % 2) * 4)) & 0xF)
+               : static_cast<Player>(cells[idx]);
+  };
+  for (int idx = 0; idx < max_valid_moves; ++idx) {
+    const Player player = unpack_cell(idx);
+    if (player < 0 || player > num_players) {
+      return false;
+    }
+  }
+  for (int idx = 0; idx < max_valid_moves; ++idx) {
+    board.Set(idx, unpack_cell(idx));
+  }
+  whose_turn = restored_turn;
+  valid_move_count = restored_count;
+
+  // Rebuild derived state: the full-line win counters and (when enabled) the
+  // position hash follow from the board contents.
+  if (win_length == board_size) {
+    fill(line_counts.begin(), line_counts.end(), 0u);
+    for (int row = 0; row < board_size; ++row) {
+      for (int col = 0; col < board_size; ++col) {
+        const Player player = Cell(row, col);
+        if (player == NO_MOVE) {
+          continue;
+        }
+        ++line_counts[LineCountIndex(player, row)];
+        ++line_counts[LineCountIndex(player, board_size + col)];
+        if (row == col) {
+          ++line_counts[LineCountIndex(player, 2 * board_size)];
+        }
+        if (row == (board_size - col - 1)) {
+          ++line_counts[LineCountIndex(player, 2 * board_size + 1)];
+        }
+      }
+    }
+    // Rebuild per-line winnability from the fresh counters.
+    fill(line_owners.begin(), line_owners.end(), int8_t{0});
+    winnable_lines = num_lines;
+    for (int line = 0; line < num_lines; ++line) {
+      RefreshLineOwner(line);
+    }
+  }
+  if (hashing_enabled) {
+    // Recomputes the absolute hash from the restored board.
+    SetHashingEnabled(true);
+  }
+  // History never survives a checkpoint.
+  history.clear();
+  redo_stack.clear();
+  return true;
+}
+
 void TicTacToe::Print() {
-  for (const auto row : board) {
-    for (const auto col : row) {
-      cout << col << " ";
+  // Render once and emit with a single write instead of one stream operation
+  // per cell.
+  string buffer;
+  Render(buffer);
+  cout << buffer;
+}
+
+void TicTacToe::Render(string &output) const {
+  output.clear();
+  // One cell plus separator per column; multi-digit players are the rare
+  // case, so reserve for the common single-digit layout and let append grow
+  // the buffer if needed.
+  output.reserve(board_size * (2 * board_size + 1));
+  for (int row = 0; row < board_size; ++row) {
+    for (int col = 0; col < board_size; ++col) {
+      const Player cell = Cell(row, col);
+      if (cell >= 0 && cell <= 9) {
+        output.push_back(static_cast<char>('0' + cell));
+      } else {
+        output += to_string(cell);
+      }
+      output.push_back(' ');
+    }
+    output.push_back('\n');
+  }
+}
+
+void TicTacToe::RenderCompact(string &output) const {
+  output.clear();
+  output.reserve(board_size * board_size + 8);
+  output += to_string(board_size);
+  output.push_back(':');
+  // One digit per cell when every player value fits one; otherwise fall back
+  // to comma separation so the form stays unambiguous.
+  const bool single_digit_cells = (num_players <= 9);
+  for (int idx = 0; idx < board_size * board_size; ++idx) {
+    const Player cell = board.Get(idx);
+    if (single_digit_cells) {
+      output.push_back(static_cast<char>('0' + cell));
+    } else {
+      if (idx != 0) {
+        output.push_back(',');
+      }
+      output += to_string(cell);
     }
-    cout << "\n";
   }
 }
 
@@ -127,18 +1027,18 @@ TicTacToe::MoveResult TicTacToe::CheckForWin(Location location, Player player) {
   for (int idx = 0; idx < board_size; ++idx) {
     // Check if row win type is possible.
     if (row_win) {
-      row_win = board[location.row][idx] == player;
+      row_win = Cell(location.row, idx) == player;
     }
     // Check if col..
     if (col_win) {
-      col_win = board[idx][location.col] == player;
+      col_win = Cell(idx, location.col) == player;
     }
     // Check if diag..
     if (diag_win_down) {
-      diag_win_down = board[idx][idx] == player;
+      diag_win_down = Cell(idx, idx) == player;
     }
     if (diag_win_up) {
-      diag_win_up = board[idx][board_size - idx - 1] == player;
+      diag_win_up = Cell(idx, board_size - idx - 1) == player;
     }
     // If no win type is still possible, we can return early.
     if (!(row_win || col_win || diag_win_down || diag_win_up)) {
@@ -149,7 +1049,70 @@ TicTacToe::MoveResult TicTacToe::CheckForWin(Location location, Player player) {
   return MoveResult::WIN;
 }
 
-TicTacToe::MoveResult TicTacToe::MakeMove(Player player, Location location) {
+TicTacToe::MoveResult TicTacToe::UpdateLineCountsAndCheckForWin(
+    Location location, Player player) {
+  // Bump <player>'s counter for each line through <location>.  A line is won
+  // exactly when its counter reaches board_size, so only the (at most four)
+  // touched counters need to be inspected.
+  const unsigned int full_line = board_size;
+  bool win = false;
+  win |= ++line_counts[LineCountIndex(player, location.row)] == full_line;
+  win |= ++line_counts[LineCountIndex(player, board_size + location.col)] ==
+         full_line;
+  if (location.row == location.col) {
+    win |= ++line_counts[LineCountIndex(player, 2 * board_size)] == full_line;
+  }
+  if (location.row == (board_size - location.col - 1)) {
+    win |=
+        ++line_counts[LineCountIndex(player, 2 * board_size + 1)] == full_line;
+  }
+  const MoveResult result = win ? MoveResult::WIN : MoveResult::CONTINUE;
+#ifdef TTT_DEBUG_CROSS_CHECK_WIN
+  // Cross-check the incremental answer against the full-line rescan.
+  if (result != CheckForWin(location, player)) {
+    TTT_THROW(std::logic_error("Incremental win check disagrees with CheckForWin."));
+  }
+#endif
+  return result;
+}
+
+TicTacToe::MoveResult TicTacToe::CheckForWinWindowed(Location location,
+                                                     Player player) const {
+  // The four line directions; each is scanned both ways from the move.
+  static constexpr int DIRECTIONS[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+  for (const auto &direction : DIRECTIONS) {
+    // The move itself is the first cell of the run.
+    int run = 1;
+    for (int sign = -1; sign <= 1; sign += 2) {
+      for (int step = 1; step < win_length; ++step) {
+        const int row = location.row + sign * step * direction[0];
+        const int col = location.col + sign * step * direction[1];
+        if (row < 0 || row >= board_size || col < 0 || col >= board_size ||
+            Cell(row, col) != player) {
+          break;
+        }
+        ++run;
+      }
+    }
+    if (run >= win_length) {
+      return MoveResult::WIN;
+    }
+  }
+  return MoveResult::CONTINUE;
+}
+
+TicTacToe::MoveResult TicTacToe::MakeMove(Player player,
+                                          Location location) noexcept {
+#ifdef TTT_INSTRUMENT
+  const uint64_t instr_start = InstrumentationCycles();
+#endif
+#ifdef TTT_TELEMETRY
+  const uint64_t telemetry_start = InstrumentationCycles();
+#endif
+  // Snapshot the state a future UndoMove would need to restore.
+  const int prior_whose_turn = whose_turn;
+  const unsigned int prior_valid_move_count = valid_move_count;
+
   // Check for invalid player moves.
   // * Wrong player has attempted to move.
   const bool wrong_player = (player != whose_turn);
@@ -164,66 +1127,1421 @@ TicTacToe::MoveResult TicTacToe::MakeMove(Player player, Location location) {
   };
   bool off_board = IsOffBoard(location.row) || IsOffBoard(location.col);
   // * Move is in an already-filled location.
-  bool already_filled = (board[location.row][location.col] != NO_MOVE);
+  bool already_filled =
+      !off_board && (Cell(location.row, location.col) != NO_MOVE);
 
+#ifdef TTT_INSTRUMENT
+  const uint64_t instr_validated = InstrumentationCycles();
+  uint64_t instr_written = instr_validated;
+  uint64_t instr_checked = instr_validated;
+#endif
   MoveResult move_result = MoveResult::NUM_MOVE_RESULT;
+  bool placed_move = false;
   if (wrong_player || off_board || already_filled) {
     move_result = MoveResult::INVALID;
   } else if (valid_move_count == max_valid_moves) {
     // We've made all the valid moves possible, so the board is filled in. Draw!
     move_result = MoveResult::DRAW;
   } else {
+    placed_move = true;
     ++valid_move_count;
-    board[location.row][location.col] = player;
-    // Returns WIN or CONTINUE.
-    move_result = CheckForWin(location, player);
+    SetCell(location.row, location.col, player);
+    if (hashing_enabled) {
+      zobrist_hash ^= ZobristKey(location, player);
+    }
+#ifdef TTT_INSTRUMENT
+    instr_written = InstrumentationCycles();
+#endif
+    // Returns WIN or CONTINUE.  Full-line games use the O(1) line counters;
+    // K-in-a-row variants scan the O(win_length) window around the move.
+    move_result = (win_length == board_size)
+                      ? UpdateLineCountsAndCheckForWin(location, player)
+                      : CheckForWinWindowed(location, player);
+    if (win_length == board_size) {
+      // Update the winnability of the touched lines; the moment no line can
+      // be completed by anyone, the game is a draw, full board or not.
+      MarkLine(location.row, player);
+      MarkLine(board_size + location.col, player);
+      if (location.row == location.col) {
+        MarkLine(2 * board_size, player);
+      }
+      if (location.row == (board_size - location.col - 1)) {
+        MarkLine(2 * board_size + 1, player);
+      }
+      if (move_result == MoveResult::CONTINUE && winnable_lines == 0) {
+        move_result = MoveResult::DRAW;
+      }
+    }
+#ifdef TTT_INSTRUMENT
+    instr_checked = InstrumentationCycles();
+#endif
   }
+#ifdef TTT_INSTRUMENT
+  tls_move_instrumentation.Record(move_result, instr_start, instr_validated,
+                                  instr_written, instr_checked);
+#endif
+
+  // Every branch above assigns a real result; assert in debug builds, and
+  // let the check compile out entirely in release (NDEBUG).
+  assert(move_result != MoveResult::NUM_MOVE_RESULT &&
+         "Should never reach here.");
 
-  if (move_result == MoveResult::NUM_MOVE_RESULT) {
-    throw std::logic_error(
-        "Invalid result NUM_MOVE_RESULT. Should never reach here.");
+  if (history_enabled) {
+    // placed_move rather than the result class: an early-draw move writes
+    // the board too.
+    history.push_back({location, player, prior_whose_turn,
+                       prior_valid_move_count, placed_move});
+    if (!replaying_redo) {
+      // A fresh move invalidates whatever was undone before it.
+      redo_stack.clear();
+    }
   }
+#ifdef TTT_TELEMETRY
+  MoveTelemetry::Record(InstrumentationCycles() - telemetry_start,
+                        move_result == MoveResult::WIN ||
+                            move_result == MoveResult::DRAW);
+#endif
   return move_result;
 }
 
-int TicTacToe::ConvertMoveResultToGameResult(MoveResult result, Player player) {
-  switch (result) {
-    case TicTacToe::MoveResult::WIN: {
-      return player;
+TicTacToe::Player TicTacToe::ScanBoard() const {
+  if (board_size > 32) {
+    // Rare giant boards: plain run scan, O(board_size^2 * win_length).
+    static constexpr int DIRECTIONS[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+    for (int row = 0; row < board_size; ++row) {
+      for (int col = 0; col < board_size; ++col) {
+        const Player player = Cell(row, col);
+        if (player == NO_MOVE) {
+          continue;
+        }
+        for (const auto &direction : DIRECTIONS) {
+          int run = 1;
+          for (int step = 1; step < win_length; ++step) {
+            const int r = row + step * direction[0];
+            const int c = col + step * direction[1];
+            if (r < 0 || r >= board_size || c < 0 || c >= board_size ||
+                Cell(r, c) != player) {
+              break;
+            }
+            ++run;
+          }
+          if (run >= win_length) {
+            return player;
+          }
+        }
+      }
     }
-    case TicTacToe::MoveResult::DRAW: {
-      return CATS_GAME;
+    return NO_MOVE;
+  }
+
+  uint32_t row_masks[32];
+  for (Player player = 1; player <= num_players; ++player) {
+    // Build one occupancy bit per cell, per row, for this player.
+    for (int row = 0; row < board_size; ++row) {
+      uint32_t mask = 0;
+      for (int col = 0; col < board_size; ++col) {
+        mask |= static_cast<uint32_t>(Cell(row, col) == player) << col;
+      }
+      row_masks[row] = mask;
     }
-    case TicTacToe::MoveResult::INVALID: {
-      return -player;
+
+    // Horizontal runs: a bit survives ANDing its own right-shifts iff
+    // win_length consecutive bits are set.
+    for (int row = 0; row < board_size; ++row) {
+      uint32_t run = row_masks[row];
+      for (int step = 1; step < win_length && run != 0; ++step) {
+        run &= row_masks[row] >> step;
+      }
+      if (run != 0) {
+        return player;
+      }
     }
-    case TicTacToe::MoveResult::CONTINUE: {
-      return NEXT_PLAYER;
+
+    // Vertical and diagonal runs: AND a window of win_length rows, shifting
+    // each row by its offset within the window to align the diagonals.
+    for (int start = 0; start + win_length <= board_size; ++start) {
+      uint32_t vertical = ~uint32_t{0};
+      uint32_t diagonal = ~uint32_t{0};
+      uint32_t anti_diagonal = ~uint32_t{0};
+      for (int i = 0; i < win_length; ++i) {
+        const uint32_t mask = row_masks[start + i];
+        vertical &= mask;
+        diagonal &= mask >> i;
+        anti_diagonal &= mask << i;
+      }
+      if ((vertical | diagonal | anti_diagonal) != 0) {
+        return player;
+      }
     }
-    case TicTacToe::MoveResult::NUM_MOVE_RESULT: {
-      throw std::logic_error(
-          "Invalid result NUM_MOVE_RESULT. Should never reach here.");
+  }
+  return NO_MOVE;
+}
+
+void TicTacToe::EnsureZobristTable() {
+  if (!zobrist_table.empty()) {
+    return;
+  }
+  // A fixed seed keeps hashes stable across runs and processes, so they can
+  // key persistent caches.
+  mt19937_64 rng(0x7157AC70E5EEDULL);
+  zobrist_table.resize(static_cast<size_t>(max_valid_moves) * num_players);
+  for (auto &key : zobrist_table) {
+    key = rng();
+  }
+}
+
+int TicTacToe::FindCanonicalTransform() const {
+  // Compare the cell sequences the transforms read out.
+  int best_transform = 0;
+  for (int transform = 1; transform < 8; ++transform) {
+    for (int row = 0; row < board_size; ++row) {
+      int verdict = 0;
+      for (int col = 0; col < board_size; ++col) {
+        const Player candidate =
+            board.Get(TransformedIndex(transform, row, col));
+        const Player best = board.Get(TransformedIndex(best_transform, row,
+                                                       col));
+        if (candidate != best) {
+          verdict = candidate < best ? -1 : 1;
+          break;
+        }
+      }
+      if (verdict != 0) {
+        if (verdict < 0) {
+          best_transform = transform;
+        }
+        break;
+      }
     }
   }
-  throw std::logic_error("Something went wrong. Should never reach here.");
-  return 0;
+  return best_transform;
 }
 
-/*
- * Complete the 'playTicTacToe' function below.
- *
- * The function is expected to return an INTEGER_ARRAY.
- *
- * The function accepts following parameters:
- *  1. TicTacToe& game object
- *  2. 2D_INTEGER_ARRAY moves - moves[i][0] = player for move i,
- *                              moves[i][1] = row for move i,
- *                              moves[i][2] = column for move i
- */
+uint64_t TicTacToe::CanonicalIndex() const {
+  const int best_transform = FindCanonicalTransform();
+  // Fold the canonical orientation's cells into base-(num_players+1) digits,
+  // first cell least significant.
+  const uint64_t base = num_players + 1;
+  uint64_t index = 0;
+  for (int idx = max_valid_moves - 1; idx >= 0; --idx) {
+    index = index * base +
+            board.Get(TransformedIndex(best_transform, idx / board_size,
+                                       idx % board_size));
+  }
+  return index;
+}
 
-vector<int> playTicTacToe(TicTacToe &game, vector<vector<int>> moves) {
-  vector<int> game_statuses;
-  for (const auto &move : moves) {
+uint64_t TicTacToe::CanonicalHash() {
+  EnsureZobristTable();
+  const int best_transform = FindCanonicalTransform();
+  // Hash the board as seen through the winning orientation.
+  uint64_t hash = 0;
+  for (int row = 0; row < board_size; ++row) {
+    for (int col = 0; col < board_size; ++col) {
+      const Player player =
+          board.Get(TransformedIndex(best_transform, row, col));
+      if (player != NO_MOVE) {
+        hash ^= zobrist_table[CellIndex(row, col) * num_players +
+                              (player - 1)];
+      }
+    }
+  }
+  return hash;
+}
+
+void TicTacToe::SetHashingEnabled(bool enabled) {
+  hashing_enabled = enabled;
+  if (!enabled) {
+    return;
+  }
+  EnsureZobristTable();
+  // Recompute the absolute hash of the current position, so games that
+  // enable hashing mid-game (e.g. per-worker copies in parallel search) key
+  // the same position identically.
+  zobrist_hash = 0;
+  for (int row = 0; row < board_size; ++row) {
+    for (int col = 0; col < board_size; ++col) {
+      const Player player = Cell(row, col);
+      if (player != NO_MOVE) {
+        zobrist_hash ^= ZobristKey(Location(row, col), player);
+      }
+    }
+  }
+}
+
+bool TicTacToe::UndoMove() {
+  if (history.empty()) {
+    return false;
+  }
+  const MoveHistoryEntry entry = history.back();
+  history.pop_back();
+  if (entry.wrote_cell) {
+    SetCell(entry.location.row, entry.location.col, NO_MOVE);
+    if (hashing_enabled) {
+      // XOR is its own inverse; this removes the move from the hash.
+      zobrist_hash ^= ZobristKey(entry.location, entry.player);
+    }
+    if (win_length == board_size) {
+      // Roll back the same counters UpdateLineCountsAndCheckForWin bumped,
+      // then recompute the touched lines' winnability from them.
+      --line_counts[LineCountIndex(entry.player, entry.location.row)];
+      --line_counts[LineCountIndex(entry.player,
+                                   board_size + entry.location.col)];
+      RefreshLineOwner(entry.location.row);
+      RefreshLineOwner(board_size + entry.location.col);
+      if (entry.location.row == entry.location.col) {
+        --line_counts[LineCountIndex(entry.player, 2 * board_size)];
+        RefreshLineOwner(2 * board_size);
+      }
+      if (entry.location.row == (board_size - entry.location.col - 1)) {
+        --line_counts[LineCountIndex(entry.player, 2 * board_size + 1)];
+        RefreshLineOwner(2 * board_size + 1);
+      }
+    }
+  }
+  whose_turn = entry.prior_whose_turn;
+  valid_move_count = entry.prior_valid_move_count;
+  redo_stack.push_back(entry);
+  return true;
+}
+
+bool TicTacToe::RedoMove() {
+  if (redo_stack.empty()) {
+    return false;
+  }
+  const MoveHistoryEntry entry = redo_stack.back();
+  redo_stack.pop_back();
+  // Replaying through MakeMove reproduces the original result and history
+  // entry; the flag keeps it from clearing the remaining redo entries.
+  replaying_redo = true;
+  MakeMove(entry.player, entry.location);
+  replaying_redo = false;
+  return true;
+}
+
+int TicTacToe::ConvertMoveResultToGameResult(MoveResult result,
+                                             Player player) noexcept {
+  switch (result) {
+    case TicTacToe::MoveResult::WIN: {
+      return player;
+    }
+    case TicTacToe::MoveResult::DRAW: {
+      return CATS_GAME;
+    }
+    case TicTacToe::MoveResult::INVALID: {
+      return -player;
+    }
+    case TicTacToe::MoveResult::CONTINUE: {
+      return NEXT_PLAYER;
+    }
+    case TicTacToe::MoveResult::NUM_MOVE_RESULT: {
+      break;
+    }
+  }
+  // A caller passing the sentinel is a bug; assert in debug builds, and
+  // report the move as invalid in release.
+  assert(!"Invalid result NUM_MOVE_RESULT. Should never reach here.");
+  return -player;
+}
+
+/// \brief Pool of reusable TicTacToe instances for mass game instantiation.
+///
+/// Games are slab-allocated in a deque (stable addresses, chunked storage)
+/// and recycled through a free list: after the pool warms up, acquiring a
+/// game is a pointer pop plus an in-place Reset with no allocator traffic at
+/// all.  All games in a pool share one (boardSize, numberPlayers)
+/// configuration, fixed at pool construction.
+class GamePool {
+ public:
+  /// \brief Constructor.
+  /// \param boardSize Board size for every game in this pool.
+  /// \param numberPlayers The number of players for every game in this pool.
+  GamePool(int boardSize, int numberPlayers)
+      : board_size(boardSize), num_players(numberPlayers) {}
+
+  /// \brief Acquire a game ready for a fresh play-through.
+  /// \return A game owned by the pool; valid until Release or pool teardown.
+  ///
+  /// Reuses a released instance when one is available (no allocation),
+  /// otherwise grows the slab by one game.
+  TicTacToe *Acquire() {
+    if (!free_list.empty()) {
+      TicTacToe *game = free_list.back();
+      free_list.pop_back();
+      game->Reset();
+      return game;
+    }
+    games.emplace_back(board_size, num_players);
+    return &games.back();
+  }
+
+  /// \brief Return \p game to the pool for reuse.
+  /// \param game A game previously obtained from Acquire on this pool.
+  void Release(TicTacToe *game) { free_list.push_back(game); }
+
+ private:
+  /// \brief Board size for every game in this pool.
+  const int board_size;
+
+  /// \brief Number of players for every game in this pool.
+  const int num_players;
+
+  /// \brief Slab of all games ever created by this pool.  deque keeps
+  /// addresses stable as the slab grows.
+  deque<TicTacToe> games;
+
+  /// \brief Released games available for reuse.
+  vector<TicTacToe *> free_list;
+};
+
+/// \brief Fixed-capacity cache of per-position values keyed on Zobrist
+/// hashes (see TicTacToe::Hash).
+///
+/// Open-addressed with a single probe and replace-on-collision: analytics
+/// workloads care about hit rate on hot positions, not completeness, and one
+/// probe keeps a lookup to a single cache-line touch.
+class TranspositionTable {
+ public:
+  /// \brief Constructor.
+  /// \param min_capacity Minimum number of entries; rounded up to the next
+  /// power of two so probing is a mask instead of a modulo.
+  explicit TranspositionTable(size_t min_capacity) {
+    size_t capacity = 1;
+    while (capacity < min_capacity) {
+      capacity *= 2;
+    }
+    entries.assign(capacity, Entry{});
+    mask = capacity - 1;
+  }
+
+  /// \brief Look up the cached value for \p hash.
+  /// \param hash The position's Zobrist hash.
+  /// \param value Filled in on a hit.
+  /// \return true on a hit.
+  bool Lookup(uint64_t hash, int &value) const {
+    const Entry &entry = entries[hash & mask];
+    if (entry.used && entry.hash == hash) {
+      value = entry.value;
+      return true;
+    }
+    return false;
+  }
+
+  /// \brief Cache \p value for \p hash, replacing whatever occupied the slot.
+  void Store(uint64_t hash, int value) {
+    entries[hash & mask] = Entry{hash, value, true};
+  }
+
+ private:
+  /// \brief One cache slot.
+  struct Entry {
+    uint64_t hash = 0;
+    int value = 0;
+    bool used = false;
+  };
+
+  /// \brief The slots; size is a power of two.
+  vector<Entry> entries;
+
+  /// \brief Index mask (capacity - 1).
+  size_t mask = 0;
+};
+
+/// \brief Transposition table shared between search threads, with lock-free
+/// per-entry access.
+///
+/// Same single-probe replace-on-collision policy as TranspositionTable, but
+/// each slot is a (key, data) pair of relaxed atomics validated with the
+/// XOR trick: key stores hash ^ data, so a torn read from a racing store
+/// simply fails validation and reads as a miss.  Entries carry the value, the
+/// search depth it was computed at, and an alpha-beta bound flag.
+class SharedTranspositionTable {
+ public:
+  /// \brief What the stored value means relative to the alpha-beta window it
+  /// was computed in.
+  enum Flag : uint8_t { EXACT = 0, LOWER_BOUND = 1, UPPER_BOUND = 2 };
+
+  /// \brief Constructor.
+  /// \param min_capacity Minimum entries; rounded up to a power of two.
+  explicit SharedTranspositionTable(size_t min_capacity) {
+    size_t capacity = 1;
+    while (capacity < min_capacity) {
+      capacity *= 2;
+    }
+    entries.reset(new Entry[capacity]);
+    mask = capacity - 1;
+  }
+
+  /// \brief Look up the cached entry for \p hash.
+  /// \return true on a validated hit, filling \p value, \p depth, \p flag.
+  bool Lookup(uint64_t hash, int &value, int &depth, uint8_t &flag) const {
+    const Entry &entry = entries[hash & mask];
+    const uint64_t key = entry.key.load(memory_order_relaxed);
+    const uint64_t data = entry.data.load(memory_order_relaxed);
+    if (data == 0 || (key ^ data) != hash) {
+      return false;
+    }
+    value = static_cast<int32_t>(data & 0xFFFFFFFFu);
+    depth = static_cast<int>((data >> 32) & 0xFF);
+    flag = static_cast<uint8_t>((data >> 40) & 0x3);
+    return true;
+  }
+
+  /// \brief Cache an entry for \p hash, replacing the slot's occupant.
+  void Store(uint64_t hash, int value, int depth, uint8_t flag) {
+    // Bit 42 marks the slot occupied so a (0, 0, EXACT) entry isn't read as
+    // empty.
+    const uint64_t data = static_cast<uint32_t>(value) |
+                          (static_cast<uint64_t>(depth & 0xFF) << 32) |
+                          (static_cast<uint64_t>(flag & 0x3) << 40) |
+                          (uint64_t{1} << 42);
+    Entry &entry = entries[hash & mask];
+    entry.key.store(hash ^ data, memory_order_relaxed);
+    entry.data.store(data, memory_order_relaxed);
+  }
+
+ private:
+  /// \brief One lock-free slot.
+  struct Entry {
+    atomic<uint64_t> key{0};
+    atomic<uint64_t> data{0};
+  };
+
+  /// \brief The slots; size is a power of two.
+  unique_ptr<Entry[]> entries;
+
+  /// \brief Index mask (capacity - 1).
+  size_t mask = 0;
+};
+
+/// \brief Negamax game-tree search with alpha-beta pruning for two-player
+/// games, driving TicTacToe::MakeMove/UndoMove in place.
+///
+/// The bot-service evaluator: no TicTacToe is ever copied — each node is a
+/// MakeMove (O(1) incremental win check) and an UndoMove (O(1) rollback), so
+/// search throughput is bounded by the engine's move hot path rather than
+/// allocator traffic.  Moves are ordered center-out, which empirically prunes
+/// best on K-in-a-row boards.
+class SearchEngine {
+ public:
+  /// \brief Outcome of a search.
+  struct Result {
+    /// \brief The best move found for the side to move; (-1, -1) if the
+    /// position has no legal moves.  Stored as plain indices (Location's
+    /// const members would make Result unassignable); see BestMove().
+    int best_row = -1;
+    int best_col = -1;
+
+    /// \brief The best move as a Location, ready for MakeMove.
+    TicTacToe::Location BestMove() const {
+      return TicTacToe::Location(best_row, best_col);
+    }
+
+    /// \brief Negamax score of the best move from the mover's perspective.
+    int score = 0;
+
+    /// \brief Nodes visited.
+    uint64_t nodes = 0;
+
+    /// \brief Search throughput, for tracking nodes/sec run-over-run.
+    double nodes_per_second = 0.0;
+  };
+
+  /// \brief Score of an immediate win; decays per ply so faster wins score
+  /// higher.
+  static constexpr int WIN_SCORE = 1 << 20;
+
+  /// \brief Constructor.
+  /// \param nodeBudget Maximum nodes to visit per FindBestMove call; the
+  /// search returns heuristic scores past the budget.
+  explicit SearchEngine(uint64_t nodeBudget = 1000000)
+      : node_budget(nodeBudget) {}
+
+  /// \brief Share \p table across searches (and, via ParallelSearchEngine,
+  /// across threads).  Enables Zobrist hashing on searched games; note the
+  /// hash is relative to the position where hashing was first enabled.
+  void SetSharedTable(SharedTranspositionTable *table) { shared_table = table; }
+
+  /// \brief Nodes visited by this engine since construction.
+  uint64_t NodesVisited() const { return nodes; }
+
+  /// \brief Evaluate a single root move to \p max_depth and restore the game.
+  /// \return The score of \p location from the mover's perspective.
+  ///
+  /// The root-split unit of work for parallel search: workers claim root
+  /// moves and evaluate them independently on their own game copies.
+  int EvaluateMove(TicTacToe &game, TicTacToe::Location location,
+                   int max_depth) {
+    game.SetMoveHistoryEnabled(true);
+    if (shared_table != nullptr) {
+      game.SetHashingEnabled(true);
+    }
+    BuildMoveOrder(game.BoardSize());
+    const TicTacToe::Player player = game.WhoseTurn();
+    const TicTacToe::MoveResult move_result = game.MakeMove(player, location);
+    int score;
+    if (move_result == TicTacToe::MoveResult::WIN) {
+      // Mirror Negamax's per-ply decay, as in FindBestMove, so the parallel
+      // root split ranks immediate wins above deeper ones too.
+      score = WIN_SCORE + max_depth;
+    } else {
+      score = -Negamax(game, max_depth - 1, -WIN_SCORE - 1, WIN_SCORE + 1);
+    }
+    game.UndoMove();
+    return score;
+  }
+
+  /// \brief Search for the best move for \p game's side to move.
+  /// \param game A two-player game in progress; used as scratch space and
+  /// restored to its entry position before returning.
+  /// \param max_depth Maximum plies to look ahead.
+  Result FindBestMove(TicTacToe &game, int max_depth) {
+    if (game.NumPlayers() != 2) {
+      TTT_THROW(std::invalid_argument("Search requires a two-player game"));
+    }
+    game.SetMoveHistoryEnabled(true);
+    if (shared_table != nullptr) {
+      game.SetHashingEnabled(true);
+    }
+    BuildMoveOrder(game.BoardSize());
+    nodes = 0;
+    // Location's members are const, so track the best move as plain indices
+    // and build the Result once at the end.
+    int best_row = -1;
+    int best_col = -1;
+    int best_score = 0;
+    int alpha = -WIN_SCORE - 1;
+    const int beta = WIN_SCORE + 1;
+    const auto start = chrono::steady_clock::now();
+    const TicTacToe::Player player = game.WhoseTurn();
+    for (const auto &cell : move_order) {
+      if (game.CellAt(cell.row, cell.col) != 0) {
+        continue;
+      }
+      const TicTacToe::Location location(cell.row, cell.col);
+      const TicTacToe::MoveResult move_result = game.MakeMove(player, location);
+      int score;
+      if (move_result == TicTacToe::MoveResult::WIN) {
+        // Mirror Negamax's per-ply decay: an immediate win carries the full
+        // remaining depth, so it strictly outranks any win found deeper.
+        score = WIN_SCORE + max_depth;
+      } else {
+        score = -Negamax(game, max_depth - 1, -beta, -alpha);
+      }
+      game.UndoMove();
+      if (best_row < 0 || score > alpha) {
+        alpha = max(alpha, score);
+        best_row = cell.row;
+        best_col = cell.col;
+        best_score = score;
+      }
+    }
+    const int64_t elapsed_ns =
+        chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() -
+                                                   start)
+            .count();
+    return Result{best_row, best_col, best_score, nodes,
+                  elapsed_ns > 0 ? nodes * 1e9 / elapsed_ns : 0.0};
+  }
+
+ private:
+  /// \brief Negamax over \p game with alpha-beta pruning.
+  /// \param depth Remaining plies; 0 evaluates as a draw-ish heuristic.
+  /// \return The score from the perspective of \p game's side to move.
+  int Negamax(TicTacToe &game, int depth, int alpha, int beta) {
+    if (depth <= 0 || nodes >= node_budget) {
+      return 0;
+    }
+    const int alpha_original = alpha;
+    uint64_t hash = 0;
+    if (shared_table != nullptr) {
+      hash = game.Hash();
+      int cached_value;
+      int cached_depth;
+      uint8_t cached_flag;
+      if (shared_table->Lookup(hash, cached_value, cached_depth,
+                               cached_flag) &&
+          cached_depth >= depth) {
+        if (cached_flag == SharedTranspositionTable::EXACT) {
+          return cached_value;
+        }
+        if (cached_flag == SharedTranspositionTable::LOWER_BOUND) {
+          alpha = max(alpha, cached_value);
+        } else {
+          beta = min(beta, cached_value);
+        }
+        if (alpha >= beta) {
+          return cached_value;
+        }
+      }
+    }
+    const TicTacToe::Player player = game.WhoseTurn();
+    bool any_move = false;
+    for (const auto &cell : move_order) {
+      if (game.CellAt(cell.row, cell.col) != 0) {
+        continue;
+      }
+      any_move = true;
+      ++nodes;
+      const TicTacToe::Location location(cell.row, cell.col);
+      const TicTacToe::MoveResult move_result = game.MakeMove(player, location);
+      int score;
+      if (move_result == TicTacToe::MoveResult::WIN) {
+        // Prefer wins that need fewer moves: deeper remaining depth means an
+        // earlier win.
+        score = WIN_SCORE + depth;
+      } else {
+        score = -Negamax(game, depth - 1, -beta, -alpha);
+      }
+      game.UndoMove();
+      alpha = max(alpha, score);
+      if (alpha >= beta) {
+        break;
+      }
+    }
+    // No empty cell left: a full board with no win is a draw.
+    const int result = any_move ? alpha : 0;
+    if (shared_table != nullptr) {
+      const uint8_t flag =
+          result <= alpha_original
+              ? SharedTranspositionTable::UPPER_BOUND
+              : (result >= beta ? SharedTranspositionTable::LOWER_BOUND
+                                : SharedTranspositionTable::EXACT);
+      shared_table->Store(hash, result, depth, flag);
+    }
+    return result;
+  }
+
+  /// \brief Precompute the center-out visiting order for an NxN board.
+  void BuildMoveOrder(int board_size) {
+    move_order.clear();
+    move_order.reserve(board_size * board_size);
+    for (int row = 0; row < board_size; ++row) {
+      for (int col = 0; col < board_size; ++col) {
+        move_order.push_back({row, col});
+      }
+    }
+    const double center = (board_size - 1) / 2.0;
+    const auto centrality = [center](const OrderedCell &cell) {
+      const double dr = cell.row - center;
+      const double dc = cell.col - center;
+      return dr * dr + dc * dc;
+    };
+    sort(move_order.begin(), move_order.end(),
+         [&](const OrderedCell &a, const OrderedCell &b) {
+           return centrality(a) < centrality(b);
+         });
+  }
+
+  /// \brief A cell in the precomputed visiting order.
+  struct OrderedCell {
+    int row;
+    int col;
+  };
+
+  /// \brief Cells sorted center-out; rebuilt per FindBestMove.
+  vector<OrderedCell> move_order;
+
+  /// \brief Maximum nodes per search.
+  const uint64_t node_budget;
+
+  /// \brief Nodes visited by the current search.
+  uint64_t nodes = 0;
+
+  /// \brief Optional shared transposition table; not owned.
+  SharedTranspositionTable *shared_table = nullptr;
+};
+
+/// \brief Root-split parallel search for the bot service.
+///
+/// Legal root moves are claimed by workers through an atomic cursor — search
+/// subtrees are uneven, so the claim-next scheduling balances load the way
+/// work-stealing would without per-thread deques.  Each worker evaluates its
+/// claimed moves on a private copy of the game with its own SearchEngine, and
+/// all workers share one lock-free transposition table so a subtree refuted
+/// by one thread prunes everyone else's.
+class ParallelSearchEngine {
+ public:
+  /// \brief Constructor.
+  /// \param numberThreads Worker count; 0 means one per hardware thread.
+  /// \param nodeBudget Per-worker node budget (see SearchEngine).
+  /// \param tableCapacity Minimum shared transposition-table entries.
+  explicit ParallelSearchEngine(unsigned int numberThreads = 0,
+                                uint64_t nodeBudget = 1000000,
+                                size_t tableCapacity = size_t{1} << 20)
+      : num_threads(numberThreads != 0
+                        ? numberThreads
+                        : max(1u, thread::hardware_concurrency())),
+        node_budget(nodeBudget),
+        table(tableCapacity) {}
+
+  /// \brief Search for the best move for \p game's side to move.
+  /// \param game A two-player game in progress; copied per worker, never
+  /// mutated.
+  /// \param max_depth Maximum plies to look ahead.
+  SearchEngine::Result FindBestMove(const TicTacToe &game, int max_depth) {
+    if (game.NumPlayers() != 2) {
+      TTT_THROW(std::invalid_argument("Search requires a two-player game"));
+    }
+    // Enumerate legal root moves center-out, matching the serial engine's
+    // tie-breaking.
+    vector<pair<int, int>> moves;
+    const int board_size = game.BoardSize();
+    for (int row = 0; row < board_size; ++row) {
+      for (int col = 0; col < board_size; ++col) {
+        if (game.CellAt(row, col) == 0) {
+          moves.push_back({row, col});
+        }
+      }
+    }
+    const double center = (board_size - 1) / 2.0;
+    sort(moves.begin(), moves.end(),
+         [center](const pair<int, int> &a, const pair<int, int> &b) {
+           const double da = (a.first - center) * (a.first - center) +
+                             (a.second - center) * (a.second - center);
+           const double db = (b.first - center) * (b.first - center) +
+                             (b.second - center) * (b.second - center);
+           return da < db;
+         });
+
+    vector<int> scores(moves.size(), 0);
+    atomic<size_t> cursor{0};
+    atomic<uint64_t> total_nodes{0};
+    const auto start = chrono::steady_clock::now();
+    const auto worker = [&]() {
+      // A private game copy per worker; the undo-driven search never touches
+      // the caller's instance.
+      TicTacToe local_game(game);
+      SearchEngine engine(node_budget);
+      engine.SetSharedTable(&table);
+      for (size_t i = cursor.fetch_add(1); i < moves.size();
+           i = cursor.fetch_add(1)) {
+        scores[i] = engine.EvaluateMove(
+            local_game, TicTacToe::Location(moves[i].first, moves[i].second),
+            max_depth);
+      }
+      total_nodes.fetch_add(engine.NodesVisited());
+    };
+    vector<thread> workers;
+    workers.reserve(num_threads - 1);
+    for (unsigned int t = 1; t < num_threads; ++t) {
+      workers.emplace_back(worker);
+    }
+    worker();
+    for (auto &w : workers) {
+      w.join();
+    }
+    const int64_t elapsed_ns =
+        chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() -
+                                                   start)
+            .count();
+
+    int best_index = -1;
+    for (size_t i = 0; i < moves.size(); ++i) {
+      if (best_index < 0 || scores[i] > scores[best_index]) {
+        best_index = static_cast<int>(i);
+      }
+    }
+    SearchEngine::Result result;
+    if (best_index >= 0) {
+      result.best_row = moves[best_index].first;
+      result.best_col = moves[best_index].second;
+      result.score = scores[best_index];
+    }
+    result.nodes = total_nodes.load();
+    result.nodes_per_second =
+        elapsed_ns > 0 ? result.nodes * 1e9 / elapsed_ns : 0.0;
+    return result;
+  }
+
+ private:
+  /// \brief Number of worker threads (including the calling thread).
+  const unsigned int num_threads;
+
+  /// \brief Per-worker node budget.
+  const uint64_t node_budget;
+
+  /// \brief The shared lock-free transposition table.
+  SharedTranspositionTable table;
+};
+
+/// \brief Lock-free concurrent move submission for one game session.
+///
+/// Wraps a TicTacToe so multiple network threads can race to deliver moves
+/// without a mutex: the turn is an atomic token, and a submission first
+/// claims it with a CAS that only the on-turn player can win.  Losers are
+/// rejected INVALID immediately without blocking; the winner has exclusive
+/// access to the underlying game until it publishes the next turn.  Unlike
+/// the single-threaded engine's legacy behavior, a rejected out-of-turn
+/// submission does not advance the turn — a late duplicate delivery must not
+/// rot the session for the player actually on turn.
+class ConcurrentGameSession {
+ public:
+  typedef TicTacToe::Player Player;
+  typedef TicTacToe::MoveResult MoveResult;
+  typedef TicTacToe::Location Location;
+
+  /// \brief Constructor.  Parameters as in the TicTacToe constructor.
+  ConcurrentGameSession(int boardSize, int numberPlayers)
+      : game(boardSize, numberPlayers),
+        num_players(numberPlayers),
+        turn_token(1) {}
+
+  /// \brief Submit a move; safe to call from any thread.
+  /// \return The move result; INVALID for out-of-turn submissions (including
+  /// races lost to the on-turn player's in-flight move).
+  MoveResult MakeMove(Player player, Location location) {
+    // Claim the turn.  Only the on-turn player's CAS can succeed; claiming
+    // with 0 also keeps a second thread submitting for the *same* player out
+    // until the move lands.
+    int expected = player;
+    if (player < 1 ||
+        !turn_token.compare_exchange_strong(expected, 0,
+                                            memory_order_acquire)) {
+      return MoveResult::INVALID;
+    }
+    const MoveResult result = game.MakeMove(player, location);
+    // Publish the next turn (the inner game advanced whose_turn the same
+    // way), releasing the board writes to the next winner.
+    turn_token.store((player % num_players) + 1, memory_order_release);
+    return result;
+  }
+
+  /// \brief Convert a move result into an actual game result.  Same contract
+  /// as TicTacToe::ConvertMoveResultToGameResult.
+  int ConvertMoveResultToGameResult(MoveResult result, Player player) {
+    return game.ConvertMoveResultToGameResult(result, player);
+  }
+
+  /// \brief Reinitialize the session for a fresh game in place.  Callers
+  /// must ensure no submissions are in flight.
+  void Reset() {
+    game.Reset();
+    turn_token.store(1, memory_order_release);
+  }
+
+  /// \brief The wrapped game, for rendering and inspection between moves.
+  TicTacToe &Game() { return game; }
+
+ private:
+  /// \brief The wrapped single-threaded game.
+  TicTacToe game;
+
+  /// \brief The number of players.
+  const int num_players;
+
+  /// \brief Whose turn it is (1-indexed); 0 while a claimed move is in
+  /// flight.
+  atomic<int> turn_token;
+};
+
+/// \brief Callback-driven asynchronous game session.
+///
+/// The engine-side half of an event loop: a session sits suspended awaiting
+/// its next (player, Location), and the network layer resumes it with
+/// SubmitMove whenever a move arrives.  The move runs through
+/// MakeMove/ConvertMoveResultToGameResult and the resulting game status is
+/// delivered to the session's callback.  Nothing ever blocks, so one OS
+/// thread can interleave submissions across tens of thousands of in-flight
+/// sessions.  Unlike the raw engine, a session latches when the game ends:
+/// submissions after a win or draw are refused without invoking the
+/// callback.
+class AsyncGameDriver {
+ public:
+  typedef TicTacToe::Player Player;
+  typedef TicTacToe::Location Location;
+
+  /// \brief Receives each move's game status; \p done is true when that
+  /// status ended the game (win or draw) and the session stops accepting
+  /// moves.
+  typedef function<void(int game_status, bool done)> StatusCallback;
+
+  /// \brief Constructor.
+  /// \param boardSize Board size, as in the TicTacToe constructor.
+  /// \param numberPlayers The number of players.
+  /// \param callback Invoked once per accepted submission; set at session
+  /// setup so the per-move path stays allocation-free.
+  AsyncGameDriver(int boardSize, int numberPlayers, StatusCallback callback)
+      : game(boardSize, numberPlayers), status_callback(move(callback)) {}
+
+  /// \brief Resume the session with the move it was awaiting.
+  /// \return true if the move was processed (callback invoked); false if the
+  /// game already finished.
+  bool SubmitMove(Player player, Location location) {
+    if (done) {
+      return false;
+    }
+    const TicTacToe::MoveResult result = game.MakeMove(player, location);
+    const int game_status =
+        game.ConvertMoveResultToGameResult(result, player);
+    done = (game_status > TicTacToe::NEXT_PLAYER);
+    status_callback(game_status, done);
+    return true;
+  }
+
+  /// \brief Whether the game has finished (win or draw delivered).
+  bool Done() const { return done; }
+
+  /// \brief Reinitialize the session for a fresh game in place, keeping the
+  /// callback.
+  void Reset() {
+    game.Reset();
+    done = false;
+  }
+
+  /// \brief The wrapped game, for rendering and inspection between moves.
+  TicTacToe &Game() { return game; }
+
+ private:
+  /// \brief The wrapped game.
+  TicTacToe game;
+
+  /// \brief Where statuses are delivered.
+  StatusCallback status_callback;
+
+  /// \brief Latched once a win or draw has been delivered.
+  bool done = false;
+};
+
+/// \brief Match-server session manager: millions of concurrent games in
+/// contiguous slabs with no per-game allocation.
+///
+/// Every game in a manager shares one (boardSize, numberPlayers, winLength)
+/// configuration, so per-game state is just the packed cells plus two bytes
+/// of scalars, stored inline in growable slabs and addressed by dense game
+/// IDs.  Cells are 2 bits for up to 3 players and 4 bits for up to 15, and
+/// full-line games carry the byte-per-line winnability index for early-draw
+/// detection, so a 3x3 game costs ~20 bytes — 10M concurrent 3x3 games fit
+/// comfortably under 256MB.  Closed games are recycled through a free list.
+/// Move semantics (turn advance on invalid moves and early-draw detection
+/// included) match TicTacToe::MakeMove.
+class GameSessionManager {
+ public:
+  typedef TicTacToe::Player Player;
+  typedef TicTacToe::MoveResult MoveResult;
+  typedef TicTacToe::Location Location;
+
+  /// \brief Dense game identifier; an index into the slabs.
+  typedef uint32_t GameId;
+
+  /// \brief Constructor.  Parameters as in the TicTacToe constructors.
+  GameSessionManager(int boardSize, int numberPlayers)
+      : GameSessionManager(boardSize, numberPlayers, boardSize) {}
+
+  GameSessionManager(int boardSize, int numberPlayers, int winLength)
+      : board_size(boardSize),
+        num_players(numberPlayers),
+        win_length(winLength),
+        max_valid_moves(boardSize * boardSize),
+        num_lines(2 * boardSize + 2),
+        bits_per_cell(numberPlayers <= 3 ? 2 : 4),
+        cells_per_word(64 / bits_per_cell),
+        words_per_game((boardSize * boardSize + cells_per_word - 1) /
+                       cells_per_word) {
+    if (numberPlayers < 1 || numberPlayers > 15) {
+      TTT_THROW(std::invalid_argument(
+          "numberPlayers out of range for packed cells"));
+    }
+  }
+
+  /// \brief Open a new game session.
+  /// \return The game's dense ID, valid until CloseGame.
+  GameId CreateGame() {
+    if (!free_ids.empty()) {
+      const GameId id = free_ids.back();
+      free_ids.pop_back();
+      // fill_n over data(): operator[] on the one-past-the-end index would
+      // be undefined behavior when recycling the last slot.
+      fill_n(cell_words.data() + static_cast<size_t>(id) * words_per_game,
+             words_per_game, 0);
+      move_counts[id] = 0;
+      turns[id] = 1;
+      if (win_length == board_size) {
+        // fill_n over data(), as for the cells: the one-past-the-end index
+        // would be undefined behavior when recycling the last slot.
+        fill_n(line_owners.data() + static_cast<size_t>(id) * num_lines,
+               num_lines, int8_t{0});
+        winnable[id] = num_lines;
+      }
+      return id;
+    }
+    const GameId id = static_cast<GameId>(move_counts.size());
+    cell_words.resize(cell_words.size() + words_per_game, 0);
+    move_counts.push_back(0);
+    turns.push_back(1);
+    if (win_length == board_size) {
+      line_owners.resize(line_owners.size() + num_lines, 0);
+      winnable.push_back(num_lines);
+    }
+    return id;
+  }
+
+  /// \brief Close \p id and recycle its slot for a future CreateGame.
+  void CloseGame(GameId id) { free_ids.push_back(id); }
+
+  /// \brief Route a move to game \p id.  Same contract and semantics as
+  /// TicTacToe::MakeMove.
+  MoveResult MakeMove(GameId id, Player player, Location location) {
+    const bool wrong_player = (player != turns[id]);
+    // Circular increment, mirroring TicTacToe's turn bookkeeping.
+    turns[id] = static_cast<uint8_t>((turns[id] % num_players) + 1);
+    const bool off_board = (location.row < 0) || (location.row >= board_size) ||
+                           (location.col < 0) || (location.col >= board_size);
+    const bool already_filled =
+        !off_board &&
+        (GetCell(id, location.row * board_size + location.col) != 0);
+    if (wrong_player || off_board || already_filled) {
+      return MoveResult::INVALID;
+    }
+    if (move_counts[id] == max_valid_moves) {
+      return MoveResult::DRAW;
+    }
+    ++move_counts[id];
+    SetCell(id, location.row * board_size + location.col, player);
+    const MoveResult result = CheckForWinWindowed(id, location, player);
+    if (win_length == board_size) {
+      // Update the touched lines' winnability; a dead board draws at once,
+      // mirroring TicTacToe's early-draw detection.
+      MarkLine(id, location.row, player);
+      MarkLine(id, board_size + location.col, player);
+      if (location.row == location.col) {
+        MarkLine(id, 2 * board_size, player);
+      }
+      if (location.row == (board_size - location.col - 1)) {
+        MarkLine(id, 2 * board_size + 1, player);
+      }
+      if (result == MoveResult::CONTINUE && winnable[id] == 0) {
+        return MoveResult::DRAW;
+      }
+    }
+    return result;
+  }
+
+  /// \brief Convert a move result into an actual game result.  Same contract
+  /// as TicTacToe::ConvertMoveResultToGameResult.
+  int ConvertMoveResultToGameResult(MoveResult result,
+                                    Player player) const noexcept {
+    switch (result) {
+      case MoveResult::WIN:
+        return player;
+      case MoveResult::DRAW:
+        return num_players + 1;  // CATS_GAME.
+      case MoveResult::INVALID:
+        return -player;
+      case MoveResult::CONTINUE:
+        return TicTacToe::NEXT_PLAYER;
+      case MoveResult::NUM_MOVE_RESULT:
+        break;
+    }
+    assert(!"Invalid result NUM_MOVE_RESULT. Should never reach here.");
+    return -player;
+  }
+
+  /// \brief The player occupying (row, col) of game \p id, or 0.
+  Player CellAt(GameId id, int row, int col) const {
+    return GetCell(id, row * board_size + col);
+  }
+
+  /// \brief The player expected to move next in game \p id.
+  int WhoseTurn(GameId id) const { return turns[id]; }
+
+  /// \brief Number of open (non-recycled) sessions.
+  size_t ActiveGames() const { return move_counts.size() - free_ids.size(); }
+
+  /// \brief Bytes of slab storage currently held, for capacity planning.
+  size_t MemoryBytes() const {
+    return cell_words.size() * sizeof(uint64_t) +
+           move_counts.size() * sizeof(uint16_t) + turns.size() +
+           line_owners.size() + winnable.size() * sizeof(int) +
+           free_ids.size() * sizeof(GameId);
+  }
+
+ private:
+  /// \brief Read packed cell \p cell_index of game \p id.
+  Player GetCell(GameId id, int cell_index) const {
+    const uint64_t word =
+        cell_words[static_cast<size_t>(id) * words_per_game +
+                   cell_index / cells_per_word];
+    const int shift = (cell_index % cells_per_word) * bits_per_cell;
+    return static_cast<Player>((word >> shift) & CellValueMask());
+  }
+
+  /// \brief Write packed cell \p cell_index of game \p id.
+  void SetCell(GameId id, int cell_index, Player player) {
+    uint64_t &word = cell_words[static_cast<size_t>(id) * words_per_game +
+                                cell_index / cells_per_word];
+    const int shift = (cell_index % cells_per_word) * bits_per_cell;
+    word = (word & ~(CellValueMask() << shift)) |
+           (static_cast<uint64_t>(player) << shift);
+  }
+
+  /// \brief Mask of one cell's value bits.
+  uint64_t CellValueMask() const { return (uint64_t{1} << bits_per_cell) - 1; }
+
+  /// \brief Update game \p id's winnability for a stone just placed on
+  /// \p line by \p player, mirroring TicTacToe::MarkLine.
+  void MarkLine(GameId id, int line, Player player) {
+    int8_t &owner = line_owners[static_cast<size_t>(id) * num_lines + line];
+    if (owner == 0) {
+      owner = static_cast<int8_t>(player);
+    } else if (owner != -1 && owner != player) {
+      owner = -1;
+      --winnable[id];
+    }
+  }
+
+  /// \brief K-in-a-row check around \p location on the packed board; same
+  /// geometry as TicTacToe::CheckForWinWindowed.
+  MoveResult CheckForWinWindowed(GameId id, Location location,
+                                 Player player) const {
+    static constexpr int DIRECTIONS[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+    for (const auto &direction : DIRECTIONS) {
+      int run = 1;
+      for (int sign = -1; sign <= 1; sign += 2) {
+        for (int step = 1; step < win_length; ++step) {
+          const int row = location.row + sign * step * direction[0];
+          const int col = location.col + sign * step * direction[1];
+          if (row < 0 || row >= board_size || col < 0 || col >= board_size ||
+              GetCell(id, row * board_size + col) != player) {
+            break;
+          }
+          ++run;
+        }
+      }
+      if (run >= win_length) {
+        return MoveResult::WIN;
+      }
+    }
+    return MoveResult::CONTINUE;
+  }
+
+  /// \brief Board size for every game.
+  const int board_size;
+
+  /// \brief Number of players for every game.
+  const int num_players;
+
+  /// \brief Win length for every game.
+  const int win_length;
+
+  /// \brief The maximum number of total moves per game.
+  const int max_valid_moves;
+
+  /// \brief Number of win lines per game.
+  const int num_lines;
+
+  /// \brief Bits per packed cell (2 or 4).
+  const int bits_per_cell;
+
+  /// \brief Cells stored per 64-bit word.
+  const int cells_per_word;
+
+  /// \brief Slab words per game.
+  const int words_per_game;
+
+  /// \brief Packed cells, words_per_game per game, indexed by GameId.
+  vector<uint64_t> cell_words;
+
+  /// \brief Per-game valid-move counters (boards up to 255x255).
+  vector<uint16_t> move_counts;
+
+  /// \brief Per-game whose-turn values (1-indexed).
+  vector<uint8_t> turns;
+
+  /// \brief Per-game per-line winnability (0 untouched / player / -1 dead),
+  /// num_lines entries per game; full-line configurations only.
+  vector<int8_t> line_owners;
+
+  /// \brief Per-game count of still-winnable lines; full-line
+  /// configurations only.
+  vector<int> winnable;
+
+  /// \brief Recycled game IDs available for CreateGame.
+  vector<GameId> free_ids;
+};
+
+/// \brief Bitboard-backed Tic Tac Toe for board sizes known at compile time.
+/// \tparam N Board size.  N x N board, win with N consecutive.  N <= 8 so a
+/// whole board fits in one uint64_t per player.
+///
+/// Same result vocabulary as TicTacToe and matching move semantics except
+/// that this engine predates early-draw detection: a dead board stays
+/// CONTINUE here until it fills, where TicTacToe reports DRAW as soon as no
+/// line is winnable.  Each player's occupied cells are a single bitmask: the
+/// occupancy check in MakeMove is one AND and the win check compares the
+/// player's mask against precomputed win-line masks.  Use this when the
+/// board size is statically known (the common 3x3 case); fall back to the
+/// dynamic TicTacToe for large or runtime board sizes.
+template <int N>
+class BitboardTicTacToe {
+  static_assert(N >= 1 && N <= 8, "Board must fit in a 64-bit mask per player");
+
+ public:
+  typedef TicTacToe::Player Player;
+  typedef TicTacToe::MoveResult MoveResult;
+  typedef TicTacToe::Location Location;
+
+  /// \brief The maximum number of players the fixed per-player mask storage
+  /// supports.
+  static constexpr int MAX_PLAYERS = 8;
+
+  /// \brief Constructor.
+  /// \param numberPlayers The number of players who will participate.
+  explicit BitboardTicTacToe(int numberPlayers)
+      : CATS_GAME(numberPlayers + 1), num_players(numberPlayers) {
+    if (numberPlayers < 1 || numberPlayers > MAX_PLAYERS) {
+      TTT_THROW(std::invalid_argument("numberPlayers out of range for bitboard"));
+    }
+    player_masks.fill(0);
+  }
+
+  /// \brief MakeMove Interface for the game playing system to add a new move
+  /// to the game.  Same contract as TicTacToe::MakeMove.
+  MoveResult MakeMove(Player player, Location location) {
+    // Check for invalid player moves, mirroring TicTacToe::MakeMove.
+    const bool wrong_player = (player != whose_turn);
+    {
+      // Circular increment whose_turn. Note that whose_turn is 1-indexed.
+      whose_turn = (whose_turn % num_players) + 1;
+    }
+    const bool off_board = (location.row < 0) || (location.row >= N) ||
+                           (location.col < 0) || (location.col >= N);
+    // Occupancy across all players is the OR of their masks; testing one bit
+    // of it is the whole already-filled check.
+    const uint64_t move_bit =
+        off_board ? 0 : CellMask(location.row, location.col);
+    const bool already_filled = (occupied_mask & move_bit) != 0;
+
+    if (wrong_player || off_board || already_filled) {
+      return MoveResult::INVALID;
+    }
+    if (valid_move_count == N * N) {
+      // We've made all the valid moves possible, so the board is filled in.
+      // Draw!
+      return MoveResult::DRAW;
+    }
+    ++valid_move_count;
+    occupied_mask |= move_bit;
+    const uint64_t mask = (player_masks[player - 1] |= move_bit);
+    // Only the (at most four) win lines through the move can have completed.
+    if ((mask & WIN_LINES[location.row]) == WIN_LINES[location.row] ||
+        (mask & WIN_LINES[N + location.col]) == WIN_LINES[N + location.col]) {
+      return MoveResult::WIN;
+    }
+    if (location.row == location.col &&
+        (mask & WIN_LINES[2 * N]) == WIN_LINES[2 * N]) {
+      return MoveResult::WIN;
+    }
+    if (location.row == (N - location.col - 1) &&
+        (mask & WIN_LINES[2 * N + 1]) == WIN_LINES[2 * N + 1]) {
+      return MoveResult::WIN;
+    }
+    return MoveResult::CONTINUE;
+  }
+
+  /// \brief Convert a move result into an actual game result.  Same contract
+  /// as TicTacToe::ConvertMoveResultToGameResult.
+  int ConvertMoveResultToGameResult(MoveResult result,
+                                    Player player) noexcept {
+    switch (result) {
+      case MoveResult::WIN:
+        return player;
+      case MoveResult::DRAW:
+        return CATS_GAME;
+      case MoveResult::INVALID:
+        return -player;
+      case MoveResult::CONTINUE:
+        return TicTacToe::NEXT_PLAYER;
+      case MoveResult::NUM_MOVE_RESULT:
+        break;
+    }
+    assert(!"Invalid result NUM_MOVE_RESULT. Should never reach here.");
+    return -player;
+  }
+
+  /// \brief Print the current game board in the same format as
+  /// TicTacToe::Print.
+  void Print() {
+    for (int row = 0; row < N; ++row) {
+      for (int col = 0; col < N; ++col) {
+        const uint64_t bit = CellMask(row, col);
+        Player cell = 0;
+        for (int p = 0; p < num_players; ++p) {
+          if (player_masks[p] & bit) {
+            cell = p + 1;
+            break;
+          }
+        }
+        cout << cell << " ";
+      }
+      cout << "\n";
+    }
+  }
+
+  // Game status definitions.
+  const int CATS_GAME;
+
+ private:
+  /// \brief The single bit for cell (row, col) in row-major order.
+  static constexpr uint64_t CellMask(int row, int col) {
+    return uint64_t{1} << (row * N + col);
+  }
+
+  /// \brief Build the 2*N+2 win-line masks at compile time: N rows, N
+  /// columns, the down diagonal, and the up diagonal — the same line
+  /// numbering as TicTacToe's line counters.
+  static constexpr array<uint64_t, 2 * N + 2> MakeWinLines() {
+    array<uint64_t, 2 * N + 2> lines{};
+    for (int idx = 0; idx < N; ++idx) {
+      for (int other = 0; other < N; ++other) {
+        lines[idx] |= CellMask(idx, other);       // Row idx.
+        lines[N + idx] |= CellMask(other, idx);   // Column idx.
+      }
+      lines[2 * N] |= CellMask(idx, idx);          // Down diagonal.
+      lines[2 * N + 1] |= CellMask(idx, N - idx - 1);  // Up diagonal.
+    }
+    return lines;
+  }
+
+  /// \brief Precomputed win-line masks.
+  static constexpr array<uint64_t, 2 * N + 2> WIN_LINES = MakeWinLines();
+
+  /// \brief One occupancy mask per player, 0-indexed (player p owns
+  /// player_masks[p - 1]).
+  array<uint64_t, MAX_PLAYERS> player_masks;
+
+  /// \brief Union of all players' masks: every occupied cell.
+  uint64_t occupied_mask = 0;
+
+  /// \brief Counter for the number of valid moves made in the game.
+  unsigned int valid_move_count = 0;
+
+  /// \brief The number of players.
+  const int num_players;
+
+  // Keep track of whose turn it is.  Player 1 goes first; 1-indexed.
+  int whose_turn = 1;
+};
+
+// Compile the common specialization even in builds that only use the dynamic
+// engine.
+template class BitboardTicTacToe<3>;
+
+/*
+ * Complete the 'playTicTacToe' function below.
+ *
+ * The function is expected to return an INTEGER_ARRAY.
+ *
+ * The function accepts following parameters:
+ *  1. TicTacToe& game object
+ *  2. 2D_INTEGER_ARRAY moves - moves[i][0] = player for move i,
+ *                              moves[i][1] = row for move i,
+ *                              moves[i][2] = column for move i
+ */
+
+vector<int> playTicTacToe(TicTacToe &game, const vector<vector<int>> &moves) {
+  vector<int> game_statuses;
+  for (const auto &move : moves) {
     const int player = move[0];
     const TicTacToe::Location location(move[1], move[2]);
     const TicTacToe::MoveResult result = game.MakeMove(player, location);
@@ -237,9 +2555,1137 @@ vector<int> playTicTacToe(TicTacToe &game, vector<vector<int>> moves) {
   return game_statuses;
 }
 
-int main() {
+/// \brief A single (player, row, col) move record, laid out contiguously for
+/// batch ingestion.
+struct MoveRecord {
+  TicTacToe::Player player;
+  int row;
+  int col;
+};
+
+/// \brief Batch variant of playTicTacToe for preparsed move arrays.
+/// \param game The game to play the moves on.
+/// \param moves Contiguous array of move records.
+/// \param num_moves Number of records in \p moves.
+/// \param game_statuses Caller-provided output buffer with room for at least
+/// \p num_moves statuses.
+/// \return The number of statuses written.
+///
+/// Semantics match playTicTacToe — one status per processed move, stopping
+/// after a win or draw — but the moves are read from a flat array and results
+/// land in a caller-preallocated buffer, so validating a full replay performs
+/// no allocations after setup.
+size_t playTicTacToe(TicTacToe &game, const MoveRecord *moves,
+                     size_t num_moves, int *game_statuses) {
+  size_t num_statuses = 0;
+  for (size_t i = 0; i < num_moves; ++i) {
+    const MoveRecord &move = moves[i];
+    const TicTacToe::Location location(move.row, move.col);
+    const TicTacToe::MoveResult result = game.MakeMove(move.player, location);
+    const int game_status =
+        game.ConvertMoveResultToGameResult(result, move.player);
+    game_statuses[num_statuses++] = game_status;
+    if (game_status > TicTacToe::NEXT_PLAYER) {
+      // Win or draw occurred, return early.
+      break;
+    }
+  }
+  return num_statuses;
+}
+
+/// \brief Classify a batch of candidate moves against \p game's current
+/// position in one pass.
+/// \param game The position to validate against; never mutated.
+/// \param moves Contiguous array of candidate records.
+/// \param num_moves Number of candidates.
+/// \param results Caller-provided output buffer with room for \p num_moves
+/// classes.
+///
+/// The candidates are independent reads over the contiguous board, so the
+/// pass streams both arrays linearly; nothing in the game changes, making
+/// this safe to run concurrently with other readers.
+void ClassifyMoves(const TicTacToe &game, const MoveRecord *moves,
+                   size_t num_moves, TicTacToe::MoveClass *results) {
+  for (size_t i = 0; i < num_moves; ++i) {
+    results[i] = game.ClassifyMove(
+        moves[i].player, TicTacToe::Location(moves[i].row, moves[i].col));
+  }
+}
+
+/// \brief Streaming reader of whitespace-separated (player, row, col) triples.
+///
+/// Pulls fixed-size chunks from the input stream and parses integers in
+/// place, so a multi-gigabyte move log is validated without per-line string
+/// allocation or ever materializing the whole log in memory.  Numbers may
+/// span chunk boundaries.
+class MoveStreamReader {
+ public:
+  /// \brief Constructor.
+  /// \param input Stream to read move records from (file or stdin).
+  explicit MoveStreamReader(istream &input) : input(input) {}
+
+  /// \brief Read the next complete (player, row, col) triple.
+  /// \param move Filled in on success.
+  /// \return true if a full triple was parsed; false at end of input.
+  bool NextMove(MoveRecord &move) {
+    return NextInt(move.player) && NextInt(move.row) && NextInt(move.col);
+  }
+
+ private:
+  /// \brief Size of one buffered read from the underlying stream.
+  static constexpr size_t CHUNK_SIZE = size_t{64} * 1024;
+
+  /// \brief Pull the next chunk from the stream.
+  /// \return true if any bytes were read.
+  bool Refill() {
+    input.read(buffer.data(), CHUNK_SIZE);
+    buffer_len = static_cast<size_t>(input.gcount());
+    buffer_pos = 0;
+    return buffer_len > 0;
+  }
+
+  /// \brief Parse the next integer, skipping any separators before it.
+  /// \param value Filled in on success.
+  /// \return true if an integer was parsed; false at end of input.
+  bool NextInt(int &value) {
+    // Skip separators: anything that can't start a number.
+    for (;;) {
+      if (buffer_pos == buffer_len && !Refill()) {
+        return false;
+      }
+      const char c = buffer[buffer_pos];
+      if ((c >= '0' && c <= '9') || c == '-') {
+        break;
+      }
+      ++buffer_pos;
+    }
+    bool negative = false;
+    if (buffer[buffer_pos] == '-') {
+      negative = true;
+      ++buffer_pos;
+    }
+    // Accumulate digits; a number may continue into the next chunk.
+    int magnitude = 0;
+    bool any_digits = false;
+    while (buffer_pos < buffer_len || Refill()) {
+      const char c = buffer[buffer_pos];
+      if (c < '0' || c > '9') {
+        break;
+      }
+      magnitude = magnitude * 10 + (c - '0');
+      any_digits = true;
+      ++buffer_pos;
+    }
+    if (!any_digits) {
+      // A bare '-' with no digits (or '-' at end of input) is not a number.
+      return false;
+    }
+    value = negative ? -magnitude : magnitude;
+    return true;
+  }
+
+  /// \brief The underlying stream.
+  istream &input;
+
+  /// \brief Current chunk of input.
+  array<char, CHUNK_SIZE> buffer;
+
+  /// \brief Number of valid bytes in <buffer>.
+  size_t buffer_len = 0;
+
+  /// \brief Read cursor within <buffer>.
+  size_t buffer_pos = 0;
+};
+
+/// \brief Streaming variant of playTicTacToe: validates moves as they arrive
+/// from \p reader and emits each game status to \p output as it is produced.
+/// \param game The game to play the moves on.
+/// \param reader Source of move records.
+/// \param output Where to write one status per line.
+///
+/// Stops after a win or draw like the other playTicTacToe overloads; the
+/// remainder of the stream is left unread.
+void playTicTacToe(TicTacToe &game, MoveStreamReader &reader,
+                   ostream &output) {
+  MoveRecord move;
+  while (reader.NextMove(move)) {
+    const TicTacToe::Location location(move.row, move.col);
+    const TicTacToe::MoveResult result = game.MakeMove(move.player, location);
+    const int game_status =
+        game.ConvertMoveResultToGameResult(result, move.player);
+    output << game_status << "\n";
+    if (game_status > TicTacToe::NEXT_PLAYER) {
+      // Win or draw occurred, return early.
+      break;
+    }
+  }
+}
+
+// Binary move-log format: an 8-byte header followed by fixed-width 3-byte
+// records, so archived games replay straight out of the page cache with no
+// parsing.
+
+/// \brief On-disk header of a binary move log.
+struct MoveLogHeader {
+  /// \brief File magic; must equal MOVE_LOG_MAGIC.
+  char magic[4];
+
+  /// \brief Format version; must equal MOVE_LOG_VERSION.
+  uint8_t version;
+
+  /// \brief Board size the archived game was played on (see the TicTacToe
+  /// constructor's boardSize).
+  uint8_t board_size;
+
+  /// \brief Number of players (see the TicTacToe constructor).
+  uint8_t num_players;
+
+  /// \brief Reserved; written as zero.
+  uint8_t reserved;
+};
+static_assert(sizeof(MoveLogHeader) == 8, "Header layout must be packed");
+
+/// \brief Expected magic bytes at the start of a binary move log.
+constexpr char MOVE_LOG_MAGIC[4] = {'T', 'T', 'T', 'B'};
+
+/// \brief Current binary move-log format version.
+constexpr uint8_t MOVE_LOG_VERSION = 1;
+
+/// \brief One fixed-width on-disk move record.
+///
+/// Fields that don't fit a byte (negative or > 254) are stored as 0xFF by the
+/// converter; such moves are off-board / wrong-player on any supported board,
+/// so they still replay as INVALID.
+struct PackedMoveRecord {
+  uint8_t player;
+  uint8_t row;
+  uint8_t col;
+};
+static_assert(sizeof(PackedMoveRecord) == 3, "Record layout must be packed");
+
+/// \brief Batch playTicTacToe over packed on-disk records.
+///
+/// Identical semantics to the MoveRecord overload, but reads the 3-byte
+/// records in place — e.g. views handed out by MmapMoveLogReader — so replay
+/// copies nothing.
+size_t playTicTacToe(TicTacToe &game, const PackedMoveRecord *moves,
+                     size_t num_moves, int *game_statuses) {
+  size_t num_statuses = 0;
+  for (size_t i = 0; i < num_moves; ++i) {
+    const PackedMoveRecord &move = moves[i];
+    const TicTacToe::Location location(move.row, move.col);
+    const TicTacToe::MoveResult result = game.MakeMove(move.player, location);
+    const int game_status =
+        game.ConvertMoveResultToGameResult(result, move.player);
+    game_statuses[num_statuses++] = game_status;
+    if (game_status > TicTacToe::NEXT_PLAYER) {
+      // Win or draw occurred, return early.
+      break;
+    }
+  }
+  return num_statuses;
+}
+
+/// \brief Memory-mapped reader of a binary move log.
+///
+/// Maps the whole file and hands out PackedMoveRecord views directly over the
+/// page cache; nothing is copied or parsed.  Throws std::runtime_error if the
+/// file can't be opened or isn't a valid move log.
+class MmapMoveLogReader {
+ public:
+  /// \brief Map \p path and validate its header.
+  explicit MmapMoveLogReader(const char *path) {
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+      TTT_THROW(std::runtime_error(string("Could not open move log: ") + path));
+    }
+    struct stat file_info;
+    if (fstat(fd, &file_info) != 0 ||
+        static_cast<size_t>(file_info.st_size) < sizeof(MoveLogHeader)) {
+      close(fd);
+      TTT_THROW(std::runtime_error(string("Not a binary move log: ") + path));
+    }
+    file_size = file_info.st_size;
+    mapping = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps its own reference to the file.
+    close(fd);
+    if (mapping == MAP_FAILED) {
+      TTT_THROW(std::runtime_error(string("Could not map move log: ") + path));
+    }
+    const MoveLogHeader *header = static_cast<const MoveLogHeader *>(mapping);
+    if (!equal(header->magic, header->magic + 4, MOVE_LOG_MAGIC) ||
+        header->version != MOVE_LOG_VERSION || header->board_size < 1 ||
+        header->num_players < 1) {
+      munmap(mapping, file_size);
+      mapping = MAP_FAILED;
+      TTT_THROW(std::runtime_error(string("Not a binary move log: ") + path));
+    }
+  }
+
+  ~MmapMoveLogReader() {
+    if (mapping != MAP_FAILED) {
+      munmap(mapping, file_size);
+    }
+  }
+
+  // The reader owns the mapping; copying would double-unmap.
+  MmapMoveLogReader(const MmapMoveLogReader &) = delete;
+  MmapMoveLogReader &operator=(const MmapMoveLogReader &) = delete;
+
+  /// \brief Board size recorded in the log header.
+  int BoardSize() const { return Header()->board_size; }
+
+  /// \brief Number of players recorded in the log header.
+  int NumPlayers() const { return Header()->num_players; }
+
+  /// \brief The move records, viewed in place over the mapping.
+  const PackedMoveRecord *Records() const {
+    return reinterpret_cast<const PackedMoveRecord *>(
+        static_cast<const char *>(mapping) + sizeof(MoveLogHeader));
+  }
+
+  /// \brief Number of complete records in the log.
+  size_t NumRecords() const {
+    return (file_size - sizeof(MoveLogHeader)) / sizeof(PackedMoveRecord);
+  }
+
+ private:
+  const MoveLogHeader *Header() const {
+    return static_cast<const MoveLogHeader *>(mapping);
+  }
+
+  /// \brief The mapped file contents.
+  void *mapping = MAP_FAILED;
+
+  /// \brief Size of the mapped file in bytes.
+  size_t file_size = 0;
+};
+
+/// \brief Convert a text move log to the binary format.
+/// \param reader Source of text move records.
+/// \param output Destination for the binary log.
+/// \param boardSize Board size to record in the header.
+/// \param numberPlayers Number of players to record in the header.
+/// \return The number of records written.
+size_t ConvertTextMoveLog(MoveStreamReader &reader, ostream &output,
+                          int boardSize, int numberPlayers) {
+  MoveLogHeader header = {};
+  copy(MOVE_LOG_MAGIC, MOVE_LOG_MAGIC + 4, header.magic);
+  header.version = MOVE_LOG_VERSION;
+  header.board_size = static_cast<uint8_t>(boardSize);
+  header.num_players = static_cast<uint8_t>(numberPlayers);
+  output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+  // Fields outside [0, 254] can't be stored exactly; 0xFF keeps them
+  // off-board / wrong-player so the replayed statuses stay INVALID.
+  const auto pack = [](int value) {
+    return (value < 0 || value > 254) ? uint8_t{0xFF}
+                                      : static_cast<uint8_t>(value);
+  };
+  size_t num_records = 0;
+  MoveRecord move;
+  while (reader.NextMove(move)) {
+    const PackedMoveRecord record = {pack(move.player), pack(move.row),
+                                     pack(move.col)};
+    output.write(reinterpret_cast<const char *>(&record), sizeof(record));
+    ++num_records;
+  }
+  return num_records;
+}
+
+/// \brief On-disk header of a tablebase file.
+struct TablebaseHeader {
+  /// \brief File magic; must equal TABLEBASE_MAGIC.
+  char magic[4];
+
+  /// \brief Format version; must equal TABLEBASE_VERSION.
+  uint8_t version;
+
+  /// \brief Board size the table was solved for.
+  uint8_t board_size;
+
+  /// \brief Number of players (always 2 today).
+  uint8_t num_players;
+
+  /// \brief Reserved; written as zero.
+  uint8_t reserved;
+};
+static_assert(sizeof(TablebaseHeader) == 8, "Header layout must be packed");
+
+/// \brief Expected magic bytes at the start of a tablebase file.
+constexpr char TABLEBASE_MAGIC[4] = {'T', 'T', 'T', 'S'};
+
+/// \brief Current tablebase format version.
+constexpr uint8_t TABLEBASE_VERSION = 1;
+
+/// \brief Exhaustively solved endgame table for small two-player boards.
+///
+/// The offline Generate pass enumerates every reachable position through
+/// MakeMove/UndoMove, memoizing game-theoretic values per canonical position
+/// (CanonicalIndex, so each symmetry orbit is solved once), and writes a
+/// dense 2-bit-per-position file.  The runtime side memory-maps that file
+/// and answers win/loss/draw for the side to move in a single load —
+/// microseconds instead of a search.
+class Tablebase {
+ public:
+  /// \brief Game-theoretic value from the perspective of the side to move.
+  /// UNKNOWN marks positions the generator never reached (e.g. boards that
+  /// already contain a completed line).
+  enum Value : uint8_t { UNKNOWN = 0, DRAW = 1, WIN = 2, LOSS = 3 };
+
+  /// \brief Solve every reachable two-player position and write the table.
+  /// \param boardSize Board size to solve; the position count is
+  /// 3^(boardSize^2), so this is for 3x3/4x4-class boards only.
+  /// \param path Destination file.
+  /// \return The number of solved positions, or 0 on I/O failure.
+  static size_t Generate(int boardSize, const char *path) {
+    uint64_t num_positions = 1;
+    for (int cell = 0; cell < boardSize * boardSize; ++cell) {
+      num_positions *= 3;
+    }
+    vector<uint8_t> values(num_positions, UNKNOWN);
+    TicTacToe game(boardSize, 2);
+    game.SetMoveHistoryEnabled(true);
+    Solve(game, values);
+
+    ofstream file(path, ios::binary);
+    if (!file) {
+      return 0;
+    }
+    TablebaseHeader header = {};
+    copy(TABLEBASE_MAGIC, TABLEBASE_MAGIC + 4, header.magic);
+    header.version = TABLEBASE_VERSION;
+    header.board_size = static_cast<uint8_t>(boardSize);
+    header.num_players = 2;
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    // Pack four 2-bit values per byte.
+    vector<uint8_t> packed((num_positions + 3) / 4, 0);
+    size_t solved = 0;
+    for (uint64_t index = 0; index < num_positions; ++index) {
+      packed[index / 4] |= values[index] << ((index % 4) * 2);
+      solved += values[index] != UNKNOWN;
+    }
+    file.write(reinterpret_cast<const char *>(packed.data()), packed.size());
+    return file.good() ? solved : 0;
+  }
+
+  /// \brief Map \p path and validate its header.
+  explicit Tablebase(const char *path) {
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+      TTT_THROW(std::runtime_error(string("Could not open tablebase: ") +
+                                   path));
+    }
+    struct stat file_info;
+    if (fstat(fd, &file_info) != 0 ||
+        static_cast<size_t>(file_info.st_size) < sizeof(TablebaseHeader)) {
+      close(fd);
+      TTT_THROW(std::runtime_error(string("Not a tablebase: ") + path));
+    }
+    file_size = file_info.st_size;
+    mapping = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+      TTT_THROW(std::runtime_error(string("Could not map tablebase: ") +
+                                   path));
+    }
+    const TablebaseHeader *header =
+        static_cast<const TablebaseHeader *>(mapping);
+    if (!equal(header->magic, header->magic + 4, TABLEBASE_MAGIC) ||
+        header->version != TABLEBASE_VERSION || header->board_size < 1) {
+      munmap(mapping, file_size);
+      mapping = MAP_FAILED;
+      TTT_THROW(std::runtime_error(string("Not a tablebase: ") + path));
+    }
+  }
+
+  ~Tablebase() {
+    if (mapping != MAP_FAILED) {
+      munmap(mapping, file_size);
+    }
+  }
+
+  // The table owns the mapping; copying would double-unmap.
+  Tablebase(const Tablebase &) = delete;
+  Tablebase &operator=(const Tablebase &) = delete;
+
+  /// \brief Board size this table was solved for.
+  int BoardSize() const {
+    return static_cast<const TablebaseHeader *>(mapping)->board_size;
+  }
+
+  /// \brief Look up the value of \p game's position for the side to move.
+  /// \return The stored value, or UNKNOWN if the game's configuration
+  /// doesn't match the table.
+  Value Probe(const TicTacToe &game) const {
+    if (game.BoardSize() != BoardSize() || game.NumPlayers() != 2) {
+      return UNKNOWN;
+    }
+    const uint64_t index = game.CanonicalIndex();
+    const uint8_t *packed =
+        static_cast<const uint8_t *>(mapping) + sizeof(TablebaseHeader);
+    if (index / 4 >= file_size - sizeof(TablebaseHeader)) {
+      return UNKNOWN;
+    }
+    return static_cast<Value>((packed[index / 4] >> ((index % 4) * 2)) & 3);
+  }
+
+ private:
+  /// \brief Solve \p game's current position, memoizing per canonical index.
+  /// \return The value for the side to move.
+  static uint8_t Solve(TicTacToe &game, vector<uint8_t> &values) {
+    const uint64_t index = game.CanonicalIndex();
+    if (values[index] != UNKNOWN) {
+      return values[index];
+    }
+    const int board_size = game.BoardSize();
+    const TicTacToe::Player player = game.WhoseTurn();
+    // Rank for the mover: LOSS < DRAW < WIN; take the best over all moves.
+    uint8_t best = UNKNOWN;
+    const auto rank = [](uint8_t value) {
+      return value == WIN ? 2 : (value == DRAW ? 1 : 0);
+    };
+    for (int row = 0; row < board_size && best != WIN; ++row) {
+      for (int col = 0; col < board_size && best != WIN; ++col) {
+        if (game.CellAt(row, col) != 0) {
+          continue;
+        }
+        const TicTacToe::MoveResult result =
+            game.MakeMove(player, TicTacToe::Location(row, col));
+        uint8_t value;
+        if (result == TicTacToe::MoveResult::WIN) {
+          value = WIN;
+        } else if (result == TicTacToe::MoveResult::DRAW) {
+          value = DRAW;
+        } else {
+          // The child's value is from the opponent's perspective.
+          const uint8_t child = Solve(game, values);
+          value = child == WIN ? LOSS : (child == LOSS ? WIN : DRAW);
+        }
+        game.UndoMove();
+        if (best == UNKNOWN || rank(value) > rank(best)) {
+          best = value;
+        }
+      }
+    }
+    if (best == UNKNOWN) {
+      // No legal move: a full (or dead) board is a draw.
+      best = DRAW;
+    }
+    values[index] = best;
+    return best;
+  }
+
+  /// \brief The mapped file contents.
+  void *mapping = MAP_FAILED;
+
+  /// \brief Size of the mapped file in bytes.
+  size_t file_size = 0;
+};
+
+/// \brief One replay to validate: a move sequence plus a caller-provided
+/// output buffer for its per-move statuses.
+struct ReplayJob {
+  /// \brief Contiguous move records for this game.
+  const MoveRecord *moves;
+
+  /// \brief Number of records in <moves>.
+  size_t num_moves;
+
+  /// \brief Caller-provided output buffer with room for <num_moves> statuses.
+  int *game_statuses;
+
+  /// \brief Number of statuses written; filled in by the validator.
+  size_t num_statuses;
+};
+
+/// \brief Parallel replay validation over independent games.
+///
+/// Games share no state, so the scheduler is a single atomic cursor over the
+/// job array: each worker claims the next unprocessed job with a fetch-add
+/// (cheap dynamic load balancing without per-deque stealing, which uniform
+/// replay jobs don't need) and runs the playTicTacToe loop on its own
+/// reusable TicTacToe instance.  Every job writes into its own caller-provided
+/// buffer, so there is no merge step and no locking anywhere.
+class ReplayValidator {
+ public:
+  /// \brief Constructor.
+  /// \param boardSize Board size for every replayed game.
+  /// \param numberPlayers The number of players in every replayed game.
+  /// \param numberThreads Worker count; 0 means one per hardware thread.
+  ReplayValidator(int boardSize, int numberPlayers,
+                  unsigned int numberThreads = 0)
+      : board_size(boardSize),
+        num_players(numberPlayers),
+        num_threads(numberThreads != 0
+                        ? numberThreads
+                        : max(1u, thread::hardware_concurrency())) {}
+
+  /// \brief Validate all of \p jobs, filling each job's game_statuses and
+  /// num_statuses.  Blocks until every replay has been processed.
+  void ValidateReplays(ReplayJob *jobs, size_t num_jobs) {
+    atomic<size_t> next_job{0};
+    const auto worker = [&]() {
+      // One game per worker, reset in place between replays.
+      TicTacToe game(board_size, num_players);
+      for (size_t i = next_job.fetch_add(1); i < num_jobs;
+           i = next_job.fetch_add(1)) {
+        game.Reset();
+        jobs[i].num_statuses = playTicTacToe(game, jobs[i].moves,
+                                             jobs[i].num_moves,
+                                             jobs[i].game_statuses);
+      }
+    };
+    vector<thread> workers;
+    workers.reserve(num_threads - 1);
+    for (unsigned int t = 1; t < num_threads; ++t) {
+      workers.emplace_back(worker);
+    }
+    // The calling thread is worker 0.
+    worker();
+    for (auto &w : workers) {
+      w.join();
+    }
+  }
+
+ private:
+  /// \brief Board size for every replayed game.
+  const int board_size;
+
+  /// \brief Number of players in every replayed game.
+  const int num_players;
+
+  /// \brief Number of worker threads (including the calling thread).
+  const unsigned int num_threads;
+};
+
+// Self-contained microbenchmark harness (no external benchmark dependency).
+// Run with: ttt --bench.  Emits CSV (benchmark,board_size,iterations,
+// ns_per_op) so CI can track run-over-run deltas.
+
+/// \brief Keep \p value alive as far as the optimizer is concerned.
+template <class T>
+inline void DoNotOptimize(const T &value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/// \brief Nanoseconds elapsed since \p start.
+static int64_t ElapsedNs(chrono::steady_clock::time_point start) {
+  return chrono::duration_cast<chrono::nanoseconds>(
+             chrono::steady_clock::now() - start)
+      .count();
+}
+
+/// \brief Emit one benchmark result row.
+static void ReportBenchmark(ostream &output, const char *name, int board_size,
+                            int64_t iterations, int64_t total_ns) {
+  output << name << "," << board_size << "," << iterations << ","
+         << (static_cast<double>(total_ns) / iterations) << "\n";
+}
+
+/// \brief Run the engine microbenchmarks, writing CSV rows to \p output.
+///
+/// Covers per-move MakeMove latency and construction/teardown cost across
+/// board sizes 3-19, the win-check cost of winning vs. non-winning moves,
+/// and full-replay throughput through playTicTacToe.
+void RunBenchmarks(ostream &output) {
+  output << "benchmark,board_size,iterations,ns_per_op\n";
+
+  // Per-move MakeMove latency: fill the board in row-major order with two
+  // players alternating, resetting in place between fills.
+  for (int board_size = 3; board_size <= 19; ++board_size) {
+    TicTacToe game(board_size, 2);
+    const int moves_per_fill = board_size * board_size;
+    // Aim for ~256k timed moves per board size.
+    const int64_t fills =
+        max(int64_t{1}, (int64_t{1} << 18) / moves_per_fill);
+    int64_t moves = 0;
+    const auto start = chrono::steady_clock::now();
+    for (int64_t fill = 0; fill < fills; ++fill) {
+      game.Reset();
+      int player = 1;
+      for (int row = 0; row < board_size; ++row) {
+        for (int col = 0; col < board_size; ++col) {
+          const TicTacToe::MoveResult result =
+              game.MakeMove(player, TicTacToe::Location(row, col));
+          DoNotOptimize(result);
+          player = (player % 2) + 1;
+          ++moves;
+        }
+      }
+    }
+    ReportBenchmark(output, "make_move", board_size, moves, ElapsedNs(start));
+  }
+
+  // Win-check cost on winning vs. non-winning moves: identical four-move
+  // prefixes, then a fifth move that either completes player 1's top row or
+  // lands on an unrelated empty cell.  The prefix cost cancels in the delta.
+  {
+    const auto play_prefix = [](TicTacToe &game) {
+      game.MakeMove(1, TicTacToe::Location(0, 0));
+      game.MakeMove(2, TicTacToe::Location(1, 0));
+      game.MakeMove(1, TicTacToe::Location(0, 1));
+      game.MakeMove(2, TicTacToe::Location(1, 1));
+    };
+    const int64_t iterations = 1 << 18;
+    TicTacToe game(3, 2);
+    for (int winning = 0; winning <= 1; ++winning) {
+      const TicTacToe::Location final_move =
+          winning ? TicTacToe::Location(0, 2) : TicTacToe::Location(2, 2);
+      const auto start = chrono::steady_clock::now();
+      for (int64_t i = 0; i < iterations; ++i) {
+        game.Reset();
+        play_prefix(game);
+        const TicTacToe::MoveResult result = game.MakeMove(1, final_move);
+        DoNotOptimize(result);
+      }
+      ReportBenchmark(output,
+                      winning ? "make_move_winning" : "make_move_nonwinning",
+                      3, iterations, ElapsedNs(start));
+    }
+  }
+
+  // Full-replay throughput through the batch playTicTacToe on the demo game.
+  {
+    const MoveRecord demo_moves[] = {
+        {1, 1, 0}, {2, 3, 3}, {3, 1, 3}, {1, 0, 2}, {2, 0, 0}, {3, 2, 2},
+        {1, 4, 1}, {2, 4, 2}, {3, 3, 1}, {1, 1, 2}, {2, 4, 3}, {3, 2, 1},
+        {1, 4, 4}, {2, 1, 1}, {3, 0, 4}, {1, 0, 1}, {2, 2, 3}, {3, 4, 0}};
+    const size_t num_moves = sizeof(demo_moves) / sizeof(demo_moves[0]);
+    int game_statuses[sizeof(demo_moves) / sizeof(demo_moves[0])];
+    const int64_t iterations = 1 << 17;
+    TicTacToe game(5, 3);
+    const auto start = chrono::steady_clock::now();
+    for (int64_t i = 0; i < iterations; ++i) {
+      game.Reset();
+      const size_t num_statuses =
+          playTicTacToe(game, demo_moves, num_moves, game_statuses);
+      DoNotOptimize(num_statuses);
+    }
+    ReportBenchmark(output, "play_replay", 5, iterations, ElapsedNs(start));
+  }
+
+  // Constructor/teardown cost across board sizes.
+  for (int board_size = 3; board_size <= 19; ++board_size) {
+    const int64_t iterations = 1 << 18;
+    const auto start = chrono::steady_clock::now();
+    for (int64_t i = 0; i < iterations; ++i) {
+      TicTacToe game(board_size, 2);
+      DoNotOptimize(game);
+    }
+    ReportBenchmark(output, "construct_teardown", board_size, iterations,
+                    ElapsedNs(start));
+  }
+}
+
+/// \brief Structure-of-arrays multi-game replay engine: W independent games
+/// stepped per iteration.
+///
+/// Within one game every move depends on the last, but across games there is
+/// none, so the engine lays W games out side by side — the W lanes of each
+/// board cell are adjacent, as are the per-lane turn and counter arrays —
+/// and advances all live lanes each iteration through staged, branch-light
+/// validation passes over lane-contiguous arrays that the compiler can
+/// vectorize.  Finished games are swapped out of their lane and replaced
+/// from the job queue, so lanes stay full until the queue drains.
+/// Independent replays aim at different cells, so the occupancy reads are
+/// per-lane gathers; the staged turn/bounds compares and status writes are
+/// the unit-stride vector work, and the layout keeps every lane's hot state
+/// within a few cache lines.  Statuses match the single-game engine exactly,
+/// including turn advance on invalid moves and early-draw detection.
+class MultiGameLaneEngine {
+ public:
+  /// \brief Constructor.
+  /// \param boardSize Board size for every replayed game.
+  /// \param numberPlayers The number of players (at most 254).
+  /// \param winLength Win length, as in the TicTacToe constructor.
+  /// \param numberLanes Games stepped per iteration.
+  MultiGameLaneEngine(int boardSize, int numberPlayers, int winLength,
+                      int numberLanes)
+      : board_size(boardSize),
+        num_players(numberPlayers),
+        win_length(winLength),
+        max_valid_moves(boardSize * boardSize),
+        num_lines(2 * boardSize + 2),
+        num_lanes(numberLanes),
+        cells(static_cast<size_t>(max_valid_moves) * numberLanes, 0),
+        line_owners(static_cast<size_t>(num_lines) * numberLanes, 0),
+        winnable(numberLanes, 0),
+        turns(numberLanes, 1),
+        move_counts(numberLanes, 0),
+        lane_jobs(numberLanes, -1),
+        staged_players(numberLanes, 0),
+        staged_rows(numberLanes, 0),
+        staged_cols(numberLanes, 0),
+        staged_valid(numberLanes, 0) {}
+
+  MultiGameLaneEngine(int boardSize, int numberPlayers)
+      : MultiGameLaneEngine(boardSize, numberPlayers, boardSize, 8) {}
+
+  /// \brief Validate all of \p jobs, filling each job's game_statuses and
+  /// num_statuses.  Semantics per game match the batch playTicTacToe.
+  void ValidateReplays(ReplayJob *jobs, size_t num_jobs) {
+    size_t next_job = 0;
+    for (int lane = 0; lane < num_lanes; ++lane) {
+      AssignNextJob(lane, jobs, num_jobs, next_job);
+    }
+    while (true) {
+      // Stage each live lane's next move into lane-contiguous arrays.
+      bool any_live = false;
+      for (int lane = 0; lane < num_lanes; ++lane) {
+        if (lane_jobs[lane] < 0) {
+          staged_players[lane] = 0;
+          staged_rows[lane] = -1;
+          staged_cols[lane] = -1;
+          continue;
+        }
+        any_live = true;
+        const ReplayJob &job = jobs[lane_jobs[lane]];
+        const MoveRecord &move = job.moves[job.num_statuses];
+        staged_players[lane] = move.player;
+        staged_rows[lane] = move.row;
+        staged_cols[lane] = move.col;
+      }
+      if (!any_live) {
+        break;
+      }
+      // Branch-light validation across lanes: unit-stride compares, then a
+      // per-lane occupancy gather.
+      for (int lane = 0; lane < num_lanes; ++lane) {
+        staged_valid[lane] =
+            static_cast<uint8_t>(staged_players[lane] == turns[lane]) &
+            static_cast<uint8_t>(
+                static_cast<unsigned int>(staged_rows[lane]) <
+                static_cast<unsigned int>(board_size)) &
+            static_cast<uint8_t>(
+                static_cast<unsigned int>(staged_cols[lane]) <
+                static_cast<unsigned int>(board_size));
+      }
+      for (int lane = 0; lane < num_lanes; ++lane) {
+        if (staged_valid[lane]) {
+          staged_valid[lane] = static_cast<uint8_t>(
+              CellAt(lane, staged_rows[lane], staged_cols[lane]) == 0);
+        }
+      }
+      // Apply the staged moves and retire finished games.
+      for (int lane = 0; lane < num_lanes; ++lane) {
+        if (lane_jobs[lane] < 0) {
+          continue;
+        }
+        ReplayJob &job = jobs[lane_jobs[lane]];
+        const int player = staged_players[lane];
+        // Circular turn advance on every attempt, as in MakeMove.
+        turns[lane] = static_cast<uint8_t>((turns[lane] % num_players) + 1);
+        int status;
+        if (!staged_valid[lane]) {
+          status = -player;
+        } else if (move_counts[lane] == max_valid_moves) {
+          status = num_players + 1;  // CATS_GAME.
+        } else {
+          ++move_counts[lane];
+          SetCell(lane, staged_rows[lane], staged_cols[lane], player);
+          bool win = CheckForWinWindowed(lane, staged_rows[lane],
+                                         staged_cols[lane], player);
+          bool draw = false;
+          if (win_length == board_size) {
+            MarkLines(lane, staged_rows[lane], staged_cols[lane], player);
+            draw = !win && winnable[lane] == 0;
+          }
+          status = win ? player : (draw ? num_players + 1 : 0);
+        }
+        job.game_statuses[job.num_statuses++] = status;
+        if (status > 0 || job.num_statuses == job.num_moves) {
+          // Win, draw, or moves exhausted: recycle the lane.
+          AssignNextJob(lane, jobs, num_jobs, next_job);
+        }
+      }
+    }
+  }
+
+ private:
+  /// \brief Point \p lane at the next queued job (skipping empty ones) and
+  /// reset the lane's game state; parks the lane when the queue is drained.
+  void AssignNextJob(int lane, ReplayJob *jobs, size_t num_jobs,
+                     size_t &next_job) {
+    lane_jobs[lane] = -1;
+    while (next_job < num_jobs) {
+      ReplayJob &job = jobs[next_job];
+      job.num_statuses = 0;
+      if (job.num_moves == 0) {
+        ++next_job;
+        continue;
+      }
+      lane_jobs[lane] = static_cast<int>(next_job++);
+      // Reset this lane's strided state in place.
+      for (int cell = 0; cell < max_valid_moves; ++cell) {
+        cells[static_cast<size_t>(cell) * num_lanes + lane] = 0;
+      }
+      for (int line = 0; line < num_lines; ++line) {
+        line_owners[static_cast<size_t>(line) * num_lanes + lane] = 0;
+      }
+      winnable[lane] = num_lines;
+      turns[lane] = 1;
+      move_counts[lane] = 0;
+      return;
+    }
+  }
+
+  /// \brief The player in \p lane's cell (row, col), or 0.
+  int CellAt(int lane, int row, int col) const {
+    return cells[static_cast<size_t>(row * board_size + col) * num_lanes +
+                 lane];
+  }
+
+  /// \brief Write \p player into \p lane's cell (row, col).
+  void SetCell(int lane, int row, int col, int player) {
+    cells[static_cast<size_t>(row * board_size + col) * num_lanes + lane] =
+        static_cast<uint8_t>(player);
+  }
+
+  /// \brief K-in-a-row check around the move, same geometry as
+  /// TicTacToe::CheckForWinWindowed.
+  bool CheckForWinWindowed(int lane, int move_row, int move_col,
+                           int player) const {
+    static constexpr int DIRECTIONS[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+    for (const auto &direction : DIRECTIONS) {
+      int run = 1;
+      for (int sign = -1; sign <= 1; sign += 2) {
+        for (int step = 1; step < win_length; ++step) {
+          const int row = move_row + sign * step * direction[0];
+          const int col = move_col + sign * step * direction[1];
+          if (row < 0 || row >= board_size || col < 0 || col >= board_size ||
+              CellAt(lane, row, col) != player) {
+            break;
+          }
+          ++run;
+        }
+      }
+      if (run >= win_length) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// \brief Update \p lane's winnability for the touched lines, mirroring
+  /// TicTacToe::MarkLine.
+  void MarkLines(int lane, int row, int col, int player) {
+    const auto mark = [this, lane, player](int line) {
+      int8_t &owner =
+          line_owners[static_cast<size_t>(line) * num_lanes + lane];
+      if (owner == 0) {
+        owner = static_cast<int8_t>(player);
+      } else if (owner != -1 && owner != player) {
+        owner = -1;
+        --winnable[lane];
+      }
+    };
+    mark(row);
+    mark(board_size + col);
+    if (row == col) {
+      mark(2 * board_size);
+    }
+    if (row == (board_size - col - 1)) {
+      mark(2 * board_size + 1);
+    }
+  }
+
+  /// \brief Board size for every replayed game.
+  const int board_size;
+
+  /// \brief Number of players in every replayed game.
+  const int num_players;
+
+  /// \brief Win length for every replayed game.
+  const int win_length;
+
+  /// \brief The maximum number of total moves per game.
+  const int max_valid_moves;
+
+  /// \brief Number of win lines per game.
+  const int num_lines;
+
+  /// \brief Games stepped per iteration.
+  const int num_lanes;
+
+  /// \brief SoA boards: the W lanes of cell c live at [c * W, c * W + W).
+  vector<uint8_t> cells;
+
+  /// \brief SoA line winnability (0 untouched / player / -1 dead).
+  vector<int8_t> line_owners;
+
+  /// \brief Per-lane count of still-winnable lines.
+  vector<int> winnable;
+
+  /// \brief Per-lane whose-turn values (1-indexed).
+  vector<uint8_t> turns;
+
+  /// \brief Per-lane valid-move counters.
+  vector<uint16_t> move_counts;
+
+  /// \brief Job index each lane is replaying, or -1 for a parked lane.
+  vector<int> lane_jobs;
+
+  // Staging arrays for the per-iteration validation passes; lane-indexed and
+  // contiguous so the compare loops vectorize.
+  vector<int> staged_players;
+  vector<int> staged_rows;
+  vector<int> staged_cols;
+  vector<uint8_t> staged_valid;
+};
+
+int main(int argc, char *argv[]) {
   int boardSize = 5;
   int numberPlayers = 3;
+
+  if (argc > 1 && string(argv[1]) == "--bench") {
+    // Microbenchmark mode: emit machine-readable engine timings.
+    RunBenchmarks(cout);
+    return 0;
+  }
+
+  if (argc > 1 && string(argv[1]) == "--convert") {
+    // Archive migration tool: convert a text move log to the binary format.
+    // Usage: ttt --convert <text-log|-> <binary-log> [boardSize]
+    //            [numberPlayers]
+    if (argc < 4) {
+      cerr << "Usage: " << argv[0]
+           << " --convert <text-log|-> <binary-log> [boardSize]"
+              " [numberPlayers]\n";
+      return 1;
+    }
+    if (argc > 4) {
+      boardSize = atoi(argv[4]);
+    }
+    if (argc > 5) {
+      numberPlayers = atoi(argv[5]);
+    }
+    if (boardSize < 1 || boardSize > 254 || numberPlayers < 1 ||
+        numberPlayers > 254) {
+      cerr << "boardSize and numberPlayers must be in [1, 254]\n";
+      return 1;
+    }
+    ifstream text_file;
+    istream *input = &cin;
+    if (string(argv[2]) != "-") {
+      text_file.open(argv[2]);
+      if (!text_file) {
+        cerr << "Could not open move log: " << argv[2] << "\n";
+        return 1;
+      }
+      input = &text_file;
+    }
+    ofstream binary_file(argv[3], ios::binary);
+    if (!binary_file) {
+      cerr << "Could not create binary log: " << argv[3] << "\n";
+      return 1;
+    }
+    MoveStreamReader reader(*input);
+    const size_t num_records =
+        ConvertTextMoveLog(reader, binary_file, boardSize, numberPlayers);
+    cout << "Wrote " << num_records << " records to " << argv[3] << "\n";
+    return binary_file.good() ? 0 : 1;
+  }
+
+  if (argc > 1 && string(argv[1]) == "--solve") {
+    // Offline tablebase generation for small boards.
+    // Usage: ttt --solve <table-file> [boardSize]
+    if (argc < 3) {
+      cerr << "Usage: " << argv[0] << " --solve <table-file> [boardSize]\n";
+      return 1;
+    }
+    int solveSize = 3;
+    if (argc > 3) {
+      solveSize = atoi(argv[3]);
+    }
+    if (solveSize < 1 || solveSize > 4) {
+      cerr << "boardSize must be in [1, 4] (position count is 3^(N*N))\n";
+      return 1;
+    }
+    const size_t solved = Tablebase::Generate(solveSize, argv[2]);
+    if (solved == 0) {
+      cerr << "Could not write tablebase: " << argv[2] << "\n";
+      return 1;
+    }
+    cout << "Solved " << solved << " canonical positions to " << argv[2]
+         << "\n";
+    return 0;
+  }
+
+  if (argc > 1 && string(argv[1]) == "--replay") {
+    // Replay a binary move log via the memory-mapped reader; the game
+    // configuration comes from the log header.
+    // Usage: ttt --replay <binary-log>
+    if (argc < 3) {
+      cerr << "Usage: " << argv[0] << " --replay <binary-log>\n";
+      return 1;
+    }
+#if defined(__cpp_exceptions)
+    try {
+#endif
+      MmapMoveLogReader reader(argv[2]);
+      TicTacToe game(reader.BoardSize(), reader.NumPlayers());
+      vector<int> game_statuses(reader.NumRecords());
+      const size_t num_statuses = playTicTacToe(
+          game, reader.Records(), reader.NumRecords(), game_statuses.data());
+      for (size_t i = 0; i < num_statuses; ++i) {
+        cout << game_statuses[i] << "\n";
+      }
+      game.Print();
+#if defined(__cpp_exceptions)
+    } catch (const std::runtime_error &error) {
+      // Without exceptions, a bad log aborts inside the reader instead.
+      cerr << error.what() << "\n";
+      return 1;
+    }
+#endif
+    return 0;
+  }
+
+  if (argc > 1) {
+    // Streaming ingestion mode: validate a move log from a file (or stdin
+    // when the path is "-") without materializing it in memory.
+    // Usage: ttt <file|-> [boardSize] [numberPlayers] [winLength]
+    if (argc > 2) {
+      boardSize = atoi(argv[2]);
+    }
+    if (argc > 3) {
+      numberPlayers = atoi(argv[3]);
+    }
+    int winLength = boardSize;
+    if (argc > 4) {
+      winLength = atoi(argv[4]);
+    }
+    if (boardSize < 1 || numberPlayers < 1 || winLength < 1 ||
+        winLength > boardSize) {
+      cerr << "Usage: " << argv[0]
+           << " <file|-> [boardSize] [numberPlayers] [winLength]\n";
+      return 1;
+    }
+    ifstream file;
+    istream *input = &cin;
+    if (string(argv[1]) != "-") {
+      file.open(argv[1]);
+      if (!file) {
+        cerr << "Could not open move log: " << argv[1] << "\n";
+        return 1;
+      }
+      input = &file;
+    }
+    TicTacToe game(boardSize, numberPlayers, winLength);
+    MoveStreamReader reader(*input);
+    playTicTacToe(game, reader, cout);
+    game.Print();
+#ifdef TTT_INSTRUMENT
+    tls_move_instrumentation.Dump(cerr);
+#endif
+#ifdef TTT_TELEMETRY
+    MoveTelemetry::ExportPrometheus(cerr);
+#endif
+    return 0;
+  }
+
   vector<vector<int>> moves;
   moves.push_back({1, 1, 0});
   moves.push_back({2, 3, 3});